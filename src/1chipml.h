@@ -16,6 +16,10 @@
 
 /* Include 1chipML methods below */
 #include "./DFT.h"
+#include "./autodiff.h"
+#include "./batch_lu.h"
+#include "./chebyshev.h"
+#include "./cholesky.h"
 #include "./FFT.h"
 #include "./fast_sincos.h"
 #include "./finite_difference.h"
@@ -23,10 +27,14 @@
 #include "./genetic.h"
 #include "./gradient_descent.h"
 #include "./jacobi.h"
+#include "./krylov.h"
 #include "./lanczos.h"
 #include "./linear_congruential_random_generator.h"
 #include "./lu_decomposition.h"
 #include "./poly_interpolation.h"
+#include "./qr_decomposition.h"
+#include "./spline_interpolation.h"
 #include "./stats.h"
+#include "./tridiagonal_eigen.h"
 
 /* -- End of file -- */
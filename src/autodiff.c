@@ -0,0 +1,256 @@
+#include "autodiff.h"
+
+/**
+ * @brief Builds a dual number from its value and derivative
+ */
+static adDual makeDual(autodiff_real value, autodiff_real derivative) {
+  adDual result = {value, derivative};
+  return result;
+}
+
+adDual adDualConstant(autodiff_real c) { return makeDual(c, 0); }
+
+autodiff_real adDualValue(adDual a) { return a.value; }
+
+adDual adDualAdd(adDual a, adDual b) {
+  return makeDual(a.value + b.value, a.derivative + b.derivative);
+}
+
+adDual adDualSub(adDual a, adDual b) {
+  return makeDual(a.value - b.value, a.derivative - b.derivative);
+}
+
+adDual adDualMul(adDual a, adDual b) {
+  return makeDual(a.value * b.value,
+                  a.derivative * b.value + a.value * b.derivative);
+}
+
+adDual adDualDiv(adDual a, adDual b) {
+  autodiff_real quotient = a.value / b.value;
+  return makeDual(quotient, (a.derivative - quotient * b.derivative) / b.value);
+}
+
+adDual adDualNeg(adDual a) { return makeDual(-a.value, -a.derivative); }
+
+adDual adDualSin(adDual a) {
+  return makeDual(sin(a.value), cos(a.value) * a.derivative);
+}
+
+adDual adDualCos(adDual a) {
+  return makeDual(cos(a.value), -sin(a.value) * a.derivative);
+}
+
+adDual adDualExp(adDual a) {
+  autodiff_real value = exp(a.value);
+  return makeDual(value, value * a.derivative);
+}
+
+adDual adDualLog(adDual a) {
+  return makeDual(log(a.value), a.derivative / a.value);
+}
+
+adDual adDualSqrt(adDual a) {
+  autodiff_real value = sqrt(a.value);
+  return makeDual(value, 0.5 * a.derivative / value);
+}
+
+adDual adDualPow(adDual a, autodiff_real p) {
+  return makeDual(pow(a.value, p), p * pow(a.value, p - 1) * a.derivative);
+}
+
+/**
+ * @brief Records an operation of one or two parents on the tape of its
+ * operands. The result is a constant when no operand is on a tape. When the
+ * tape is full, the operation is only counted in the size of the tape
+ *
+ * @param a First operand
+ * @param partialA Partial derivative of the result with respect to a
+ * @param b Second operand, or a constant for unary operations
+ * @param partialB Partial derivative of the result with respect to b
+ * @param value Value of the result
+ * @return The recorded result
+ */
+static adVar record(adVar a, autodiff_real partialA, adVar b,
+                    autodiff_real partialB, autodiff_real value) {
+  adVar result = {a.tape != NULL ? a.tape : b.tape, -1, value};
+  if (result.tape == NULL) {
+    return result;
+  }
+
+  // Operands past the capacity keep their tape, so that the operations
+  // depending on them are still counted
+  ADTape* tape = result.tape;
+  int index = tape->size++;
+  if (index < tape->capacity) {
+    ADTapeNode* node = &tape->nodes[index];
+    node->parents[0] = a.index;
+    node->partials[0] = partialA;
+    node->parents[1] = b.index;
+    node->partials[1] = partialB;
+    result.index = index;
+  }
+  return result;
+}
+
+adVar adVarConstant(autodiff_real c) {
+  adVar result = {NULL, -1, c};
+  return result;
+}
+
+autodiff_real adVarValue(adVar a) { return a.value; }
+
+adVar adVarAdd(adVar a, adVar b) {
+  return record(a, 1, b, 1, a.value + b.value);
+}
+
+adVar adVarSub(adVar a, adVar b) {
+  return record(a, 1, b, -1, a.value - b.value);
+}
+
+adVar adVarMul(adVar a, adVar b) {
+  return record(a, b.value, b, a.value, a.value * b.value);
+}
+
+adVar adVarDiv(adVar a, adVar b) {
+  autodiff_real quotient = a.value / b.value;
+  return record(a, 1 / b.value, b, -quotient / b.value, quotient);
+}
+
+adVar adVarNeg(adVar a) {
+  return record(a, -1, adVarConstant(0), 0, -a.value);
+}
+
+adVar adVarSin(adVar a) {
+  return record(a, cos(a.value), adVarConstant(0), 0, sin(a.value));
+}
+
+adVar adVarCos(adVar a) {
+  return record(a, -sin(a.value), adVarConstant(0), 0, cos(a.value));
+}
+
+adVar adVarExp(adVar a) {
+  autodiff_real value = exp(a.value);
+  return record(a, value, adVarConstant(0), 0, value);
+}
+
+adVar adVarLog(adVar a) {
+  return record(a, 1 / a.value, adVarConstant(0), 0, log(a.value));
+}
+
+adVar adVarSqrt(adVar a) {
+  autodiff_real value = sqrt(a.value);
+  return record(a, 0.5 / value, adVarConstant(0), 0, value);
+}
+
+adVar adVarPow(adVar a, autodiff_real p) {
+  return record(a, p * pow(a.value, p - 1), adVarConstant(0), 0,
+                pow(a.value, p));
+}
+
+/**
+ * @brief Computes the exact gradient of a function in forward mode, with one
+ * evaluation of func on dual numbers per dimension. It is the cheapest mode
+ * for functions of a few dimensions
+ *
+ * @param func The function written with dual numbers
+ * @param point The point at which to compute the gradient
+ * @param grad Return parameter containing the gradient
+ * @param n Number of dimensions of the function, at least 1
+ * @return The value of the function at point
+ */
+autodiff_real dualGradient(adDualFunction func, const autodiff_real point[],
+                           autodiff_real grad[], int n) {
+  adDual x[n];
+  adDual result = adDualConstant(0);
+  for (int i = 0; i < n; i++) {
+    x[i] = adDualConstant(point[i]);
+  }
+
+  for (int i = 0; i < n; i++) {
+    x[i].derivative = 1;
+    result = func(x);
+    grad[i] = result.derivative;
+    x[i].derivative = 0;
+  }
+  return result.value;
+}
+
+/**
+ * @brief Initializes an empty tape
+ *
+ * @param tape The tape to initialize
+ * @param nodes Storage for capacity operations
+ * @param capacity Maximum number of operations, including one per dimension
+ */
+void tapeInit(ADTape* tape, ADTapeNode* nodes, int capacity) {
+  tape->nodes = nodes;
+  tape->capacity = capacity;
+  tape->size = 0;
+}
+
+/**
+ * @brief Computes the exact gradient of a function in reverse mode. func is
+ * evaluated once while its operations are recorded on the tape, then a single
+ * backward sweep gives every partial derivative, whatever the number of
+ * dimensions
+ *
+ * @param func The function written with tape variables
+ * @param tape The tape, cleared before the evaluation
+ * @param point The point at which to compute the gradient
+ * @param grad Return parameter containing the gradient
+ * @param n Number of dimensions of the function
+ * @param value Return parameter containing the value of the function at
+ * point. Can be NULL
+ * @return AUTODIFF_SUCCESS or AUTODIFF_TAPE_OVERFLOW if the tape is too small,
+ * in which case tape->size is the capacity needed
+ */
+int tapeGradient(adVarFunction func, ADTape* tape,
+                 const autodiff_real point[], autodiff_real grad[], int n,
+                 autodiff_real* value) {
+  adVar x[n];
+  tape->size = 0;
+
+  // The inputs are the first nodes and have no parents
+  for (int i = 0; i < n; i++) {
+    adVar input = {tape, tape->size++, point[i]};
+    if (input.index < tape->capacity) {
+      ADTapeNode* node = &tape->nodes[input.index];
+      node->parents[0] = -1;
+      node->parents[1] = -1;
+    } else {
+      input.index = -1;
+    }
+    x[i] = input;
+  }
+
+  adVar result = func(x);
+  if (value != NULL) {
+    *value = result.value;
+  }
+  if (tape->size > tape->capacity) {
+    return AUTODIFF_TAPE_OVERFLOW;
+  }
+
+  for (int k = 0; k < tape->size; k++) {
+    tape->nodes[k].adjoint = 0;
+  }
+  if (result.index >= 0) {
+    tape->nodes[result.index].adjoint = 1;
+  }
+
+  // Nodes are recorded after their parents
+  for (int k = tape->size - 1; k >= n; k--) {
+    const ADTapeNode* node = &tape->nodes[k];
+    for (int p = 0; p < 2; p++) {
+      if (node->parents[p] >= 0) {
+        tape->nodes[node->parents[p]].adjoint +=
+            node->partials[p] * node->adjoint;
+      }
+    }
+  }
+
+  for (int i = 0; i < n; i++) {
+    grad[i] = tape->nodes[i].adjoint;
+  }
+  return AUTODIFF_SUCCESS;
+}
@@ -0,0 +1,145 @@
+#ifndef AUTODIFF_H
+#define AUTODIFF_H
+
+#include <math.h>
+#include <stddef.h>
+
+#ifndef REAL_NUMBER
+#define REAL_NUMBER double
+#endif
+
+#define AUTODIFF_SUCCESS 0
+#define AUTODIFF_TAPE_OVERFLOW 1
+
+typedef REAL_NUMBER autodiff_real;
+
+/*
+ * The three kinds of numbers an objective can be written with: adReal for
+ * plain evaluations, adDual for forward mode and adVar for reverse mode. An
+ * objective written once with the AD_ macros below, where K is Real, Dual or
+ * Var, can be instantiated for each kind:
+ *
+ * #define SPHERE(K)                                  \
+ *   AD_TYPE(K) sphere##K(AD_TYPE(K) x[]) {           \
+ *     AD_TYPE(K) sum = AD_CONSTANT(K, 0);            \
+ *     for (int i = 0; i < N; i++) {                  \
+ *       sum = AD_ADD(K, sum, AD_MUL(K, x[i], x[i])); \
+ *     }                                              \
+ *     return sum;                                    \
+ *   }
+ * SPHERE(Real)
+ * SPHERE(Dual)
+ * SPHERE(Var)
+ */
+typedef autodiff_real adReal;
+
+// Value and derivative along the seeded direction
+typedef struct {
+  autodiff_real value;
+  autodiff_real derivative;
+} adDual;
+
+// Operation recorded on a tape: the result depends on up to two parents, with
+// the given partial derivatives. A parent index of -1 is unused
+typedef struct {
+  int parents[2];
+  autodiff_real partials[2];
+  autodiff_real adjoint;
+} ADTapeNode;
+
+// Caller-provided storage of the operations of one evaluation. size keeps
+// counting past capacity, so that it gives the capacity needed after an
+// overflow
+typedef struct {
+  ADTapeNode* nodes;
+  int capacity;
+  int size;
+} ADTape;
+
+// Value recorded on a tape. Constants have no tape and an index of -1, values
+// computed after the tape is full keep their tape and an index of -1
+typedef struct {
+  ADTape* tape;
+  int index;
+  autodiff_real value;
+} adVar;
+
+typedef adReal (*adRealFunction)(adReal[]);
+typedef adDual (*adDualFunction)(adDual[]);
+typedef adVar (*adVarFunction)(adVar[]);
+
+#define AD_TYPE(K) ad##K
+#define AD_CONSTANT(K, c) ad##K##Constant(c)
+#define AD_VALUE(K, a) ad##K##Value(a)
+#define AD_ADD(K, a, b) ad##K##Add(a, b)
+#define AD_SUB(K, a, b) ad##K##Sub(a, b)
+#define AD_MUL(K, a, b) ad##K##Mul(a, b)
+#define AD_DIV(K, a, b) ad##K##Div(a, b)
+#define AD_NEG(K, a) ad##K##Neg(a)
+#define AD_SIN(K, a) ad##K##Sin(a)
+#define AD_COS(K, a) ad##K##Cos(a)
+#define AD_EXP(K, a) ad##K##Exp(a)
+#define AD_LOG(K, a) ad##K##Log(a)
+#define AD_SQRT(K, a) ad##K##Sqrt(a)
+#define AD_POW(K, a, p) ad##K##Pow(a, p)
+
+// Plain numbers, without any overhead
+#define adRealConstant(c) ((adReal)(c))
+#define adRealValue(a) (a)
+#define adRealAdd(a, b) ((a) + (b))
+#define adRealSub(a, b) ((a) - (b))
+#define adRealMul(a, b) ((a) * (b))
+#define adRealDiv(a, b) ((a) / (b))
+#define adRealNeg(a) (-(a))
+#define adRealSin(a) sin(a)
+#define adRealCos(a) cos(a)
+#define adRealExp(a) exp(a)
+#define adRealLog(a) log(a)
+#define adRealSqrt(a) sqrt(a)
+#define adRealPow(a, p) pow(a, p)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+adDual adDualConstant(autodiff_real c);
+autodiff_real adDualValue(adDual a);
+adDual adDualAdd(adDual a, adDual b);
+adDual adDualSub(adDual a, adDual b);
+adDual adDualMul(adDual a, adDual b);
+adDual adDualDiv(adDual a, adDual b);
+adDual adDualNeg(adDual a);
+adDual adDualSin(adDual a);
+adDual adDualCos(adDual a);
+adDual adDualExp(adDual a);
+adDual adDualLog(adDual a);
+adDual adDualSqrt(adDual a);
+adDual adDualPow(adDual a, autodiff_real p);
+
+adVar adVarConstant(autodiff_real c);
+autodiff_real adVarValue(adVar a);
+adVar adVarAdd(adVar a, adVar b);
+adVar adVarSub(adVar a, adVar b);
+adVar adVarMul(adVar a, adVar b);
+adVar adVarDiv(adVar a, adVar b);
+adVar adVarNeg(adVar a);
+adVar adVarSin(adVar a);
+adVar adVarCos(adVar a);
+adVar adVarExp(adVar a);
+adVar adVarLog(adVar a);
+adVar adVarSqrt(adVar a);
+adVar adVarPow(adVar a, autodiff_real p);
+
+autodiff_real dualGradient(adDualFunction func, const autodiff_real point[],
+                           autodiff_real grad[], int n);
+
+void tapeInit(ADTape* tape, ADTapeNode* nodes, int capacity);
+int tapeGradient(adVarFunction func, ADTape* tape,
+                 const autodiff_real point[], autodiff_real grad[], int n,
+                 autodiff_real* value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,197 @@
+#include "batch_lu.h"
+#include <math.h>
+
+/**
+ * @brief LU decomposition with partial pivoting of a batch of interleaved
+ * systems. When size is a compile-time constant, the loops over the rows and
+ * columns are fully known and only the loops over the batch remain
+ *
+ * @param matrices The interleaved matrices. Will contain L and U
+ * @param pivots Output array of size * batchSize elements. Row i of system b
+ * was swapped with row pivots[i * batchSize + b] at step i
+ * @param size Size of the matrices
+ * @param batchSize Number of systems
+ * @return BATCH_SUCCESS or BATCH_SINGULAR if any matrix is singular
+ */
+static inline int factorizeKernel(batch_real* restrict matrices,
+                                  int* restrict pivots, const int size,
+                                  const int batchSize) {
+  int status = BATCH_SUCCESS;
+
+  for (int k = 0; k < size; ++k) {
+    batch_real* restrict pivotRow = &matrices[k * size * batchSize];
+
+    // The pivot differs from one system to the other, so the search and the
+    // swap are done system by system
+    for (int b = 0; b < batchSize; ++b) {
+      int pivot = k;
+      batch_real largest = fabs(pivotRow[k * batchSize + b]);
+      for (int i = k + 1; i < size; ++i) {
+        batch_real element = fabs(matrices[(i * size + k) * batchSize + b]);
+        if (element > largest) {
+          largest = element;
+          pivot = i;
+        }
+      }
+      pivots[k * batchSize + b] = pivot;
+      if (largest == 0) {
+        status = BATCH_SINGULAR;
+      }
+      if (pivot != k) {
+        batch_real* restrict other = &matrices[pivot * size * batchSize];
+        for (int j = 0; j < size; ++j) {
+          batch_real tmp = pivotRow[j * batchSize + b];
+          pivotRow[j * batchSize + b] = other[j * batchSize + b];
+          other[j * batchSize + b] = tmp;
+        }
+      }
+    }
+
+    // The elimination is the same for every system
+    for (int i = k + 1; i < size; ++i) {
+      batch_real* restrict row = &matrices[i * size * batchSize];
+      for (int b = 0; b < batchSize; ++b) {
+        row[k * batchSize + b] /= pivotRow[k * batchSize + b];
+      }
+      for (int j = k + 1; j < size; ++j) {
+        for (int b = 0; b < batchSize; ++b) {
+          row[j * batchSize + b] -=
+              row[k * batchSize + b] * pivotRow[j * batchSize + b];
+        }
+      }
+    }
+  }
+
+  return status;
+}
+
+/**
+ * @brief Solve a batch of interleaved systems from the factorization computed
+ * by factorizeKernel
+ *
+ * @param matrices The interleaved L and U matrices
+ * @param pivots The pivots of every system
+ * @param size Size of the matrices
+ * @param batchSize Number of systems
+ * @param vectors The interleaved right-hand sides. Will contain the solutions
+ */
+static inline void solveKernel(const batch_real* restrict matrices,
+                               const int* restrict pivots, const int size,
+                               const int batchSize,
+                               batch_real* restrict vectors) {
+  // Apply the permutation of every system
+  for (int i = 0; i < size; ++i) {
+    for (int b = 0; b < batchSize; ++b) {
+      int pivot = pivots[i * batchSize + b];
+      if (pivot != i) {
+        batch_real tmp = vectors[i * batchSize + b];
+        vectors[i * batchSize + b] = vectors[pivot * batchSize + b];
+        vectors[pivot * batchSize + b] = tmp;
+      }
+    }
+  }
+
+  // Forward substitution with the unit lower triangle
+  for (int i = 1; i < size; ++i) {
+    for (int k = 0; k < i; ++k) {
+      const batch_real* restrict factor = &matrices[(i * size + k) * batchSize];
+      for (int b = 0; b < batchSize; ++b) {
+        vectors[i * batchSize + b] -= factor[b] * vectors[k * batchSize + b];
+      }
+    }
+  }
+
+  // Backward substitution with the upper triangle
+  for (int i = size - 1; i >= 0; --i) {
+    for (int k = i + 1; k < size; ++k) {
+      const batch_real* restrict factor = &matrices[(i * size + k) * batchSize];
+      for (int b = 0; b < batchSize; ++b) {
+        vectors[i * batchSize + b] -= factor[b] * vectors[k * batchSize + b];
+      }
+    }
+    const batch_real* restrict diagonal = &matrices[(i * size + i) * batchSize];
+    for (int b = 0; b < batchSize; ++b) {
+      vectors[i * batchSize + b] /= diagonal[b];
+    }
+  }
+}
+
+typedef int (*batchFactorizeType)(batch_real*, int*, const int);
+typedef void (*batchSolveType)(const batch_real*, const int*, const int,
+                               batch_real*);
+
+// Generates the kernels of a fixed size, where the size is a constant
+#define BATCH_FIXED_KERNELS(N)                                                 \
+  static int factorize##N(batch_real* matrices, int* pivots,                   \
+                          const int batchSize) {                               \
+    return factorizeKernel(matrices, pivots, N, batchSize);                    \
+  }                                                                            \
+  static void solve##N(const batch_real* matrices, const int* pivots,          \
+                       const int batchSize, batch_real* vectors) {             \
+    solveKernel(matrices, pivots, N, batchSize, vectors);                      \
+  }
+
+BATCH_FIXED_KERNELS(3)
+BATCH_FIXED_KERNELS(4)
+BATCH_FIXED_KERNELS(5)
+BATCH_FIXED_KERNELS(6)
+BATCH_FIXED_KERNELS(7)
+BATCH_FIXED_KERNELS(8)
+BATCH_FIXED_KERNELS(9)
+BATCH_FIXED_KERNELS(10)
+BATCH_FIXED_KERNELS(11)
+BATCH_FIXED_KERNELS(12)
+BATCH_FIXED_KERNELS(13)
+BATCH_FIXED_KERNELS(14)
+BATCH_FIXED_KERNELS(15)
+BATCH_FIXED_KERNELS(16)
+
+static const batchFactorizeType fixedFactorize[] = {
+    factorize3,  factorize4,  factorize5,  factorize6,  factorize7,
+    factorize8,  factorize9,  factorize10, factorize11, factorize12,
+    factorize13, factorize14, factorize15, factorize16};
+
+static const batchSolveType fixedSolve[] = {
+    solve3,  solve4,  solve5,  solve6,  solve7,  solve8,  solve9,
+    solve10, solve11, solve12, solve13, solve14, solve15, solve16};
+
+/**
+ * @brief Perform the LU decomposition with partial pivoting of batchSize
+ * matrices of the same size stored interleaved. Sizes between
+ * BATCH_MIN_FIXED_SIZE and BATCH_MAX_FIXED_SIZE use a kernel specialized for
+ * that size. A singular matrix does not stop the factorization of the others
+ *
+ * @param matrices The interleaved matrices. Will contain L and U
+ * @param pivots Output array of size * batchSize elements
+ * @param size Size of the matrices
+ * @param batchSize Number of systems
+ * @return BATCH_SUCCESS or BATCH_SINGULAR if any matrix is singular
+ */
+int batchLUFactorize(batch_real* matrices, int* pivots, const int size,
+                     const int batchSize) {
+  if (size >= BATCH_MIN_FIXED_SIZE && size <= BATCH_MAX_FIXED_SIZE) {
+    return fixedFactorize[size - BATCH_MIN_FIXED_SIZE](matrices, pivots,
+                                                       batchSize);
+  }
+  return factorizeKernel(matrices, pivots, size, batchSize);
+}
+
+/**
+ * @brief Solve batchSize systems stored interleaved from the factorization
+ * computed by batchLUFactorize
+ *
+ * @param matrices The L and U matrices computed by batchLUFactorize
+ * @param pivots The pivots computed by batchLUFactorize
+ * @param size Size of the matrices
+ * @param batchSize Number of systems
+ * @param vectors The interleaved right-hand sides. Will contain the solutions
+ */
+void batchLUSolve(const batch_real* matrices, const int* pivots,
+                  const int size, const int batchSize, batch_real* vectors) {
+  if (size >= BATCH_MIN_FIXED_SIZE && size <= BATCH_MAX_FIXED_SIZE) {
+    fixedSolve[size - BATCH_MIN_FIXED_SIZE](matrices, pivots, batchSize,
+                                            vectors);
+    return;
+  }
+  solveKernel(matrices, pivots, size, batchSize, vectors);
+}
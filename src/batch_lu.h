@@ -0,0 +1,37 @@
+#ifndef BATCH_LU_H
+#define BATCH_LU_H
+
+#ifndef BATCH_REAL_NUMBER
+#define BATCH_REAL_NUMBER double
+#endif
+
+typedef BATCH_REAL_NUMBER batch_real;
+
+#define BATCH_SUCCESS 0
+#define BATCH_SINGULAR 1
+
+// Range of sizes for which a kernel with a compile-time size is generated.
+// Other sizes use the generic kernel
+#define BATCH_MIN_FIXED_SIZE 3
+#define BATCH_MAX_FIXED_SIZE 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * The batchSize systems are stored interleaved (structure of arrays): element
+ * (i, j) of system b is matrices[(i * size + j) * batchSize + b] and element i
+ * of right-hand side b is vectors[i * batchSize + b]. Every loop of the
+ * kernels runs over the batch dimension last, on contiguous memory
+ */
+int batchLUFactorize(batch_real* matrices, int* pivots, const int size,
+                     const int batchSize);
+void batchLUSolve(const batch_real* matrices, const int* pivots,
+                  const int size, const int batchSize, batch_real* vectors);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
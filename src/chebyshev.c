@@ -0,0 +1,158 @@
+#include "chebyshev.h"
+#include "utils.h"
+#include <math.h>
+
+/**
+ * @brief Computes the Chebyshev coefficients of the polynomial interpolating
+ * func at the nbNodes Chebyshev nodes of the first kind mapped on [a, b]
+ * @param func The function to approximate
+ * @param a Lower bound of the interval
+ * @param b Upper bound of the interval
+ * @param nbNodes Number of nodes
+ * @param coefficients Output array of nbNodes coefficients
+ */
+static void chebyshevFit(chebyshev_function func, const chebyshev_real a,
+                         const chebyshev_real b, const int nbNodes,
+                         chebyshev_real* coefficients) {
+  chebyshev_real samples[nbNodes];
+  const chebyshev_real halfWidth = 0.5 * (b - a);
+  const chebyshev_real center = 0.5 * (b + a);
+
+  for (int k = 0; k < nbNodes; ++k) {
+    chebyshev_real node = cos(M_PI * (k + 0.5) / nbNodes);
+    samples[k] = func(center + halfWidth * node);
+  }
+
+  for (int j = 0; j < nbNodes; ++j) {
+    chebyshev_real sum = 0;
+    for (int k = 0; k < nbNodes; ++k) {
+      sum += samples[k] * cos(M_PI * j * (k + 0.5) / nbNodes);
+    }
+    coefficients[j] = 2.0 * sum / nbNodes;
+  }
+  // T_0 is counted once in the sum
+  coefficients[0] *= 0.5;
+}
+
+/**
+ * @brief Builds a Chebyshev approximation of func on [a, b] whose error is
+ * about tol. The number of nodes starts at CHEBYSHEV_INITIAL_NODES and is
+ * doubled until the last coefficients are negligible, then the series is
+ * truncated to the smallest degree meeting the tolerance.
+ * @param func The function to approximate
+ * @param a Lower bound of the interval
+ * @param b Upper bound of the interval
+ * @param tol The target absolute error
+ * @param maxDegree The maximum degree of the approximation
+ * @param coefficients Buffer of maxDegree + 1 elements receiving the
+ * coefficients
+ * @param approximation The approximation to evaluate
+ * @return CHEBYSHEV_SUCCESS, CHEBYSHEV_NOT_CONVERGED if maxDegree was not
+ * enough to reach the tolerance, in which case the approximation of degree
+ * maxDegree is still returned, or CHEBYSHEV_INVALID_DEGREE if maxDegree is
+ * negative
+ */
+int chebyshevBuild(chebyshev_function func, const chebyshev_real a,
+                   const chebyshev_real b, const chebyshev_real tol,
+                   const int maxDegree, chebyshev_real* coefficients,
+                   ChebyshevApproximation* approximation) {
+  if (maxDegree < 0) {
+    return CHEBYSHEV_INVALID_DEGREE;
+  }
+
+  int nbNodes = CHEBYSHEV_INITIAL_NODES < maxDegree + 1
+                    ? CHEBYSHEV_INITIAL_NODES
+                    : maxDegree + 1;
+
+  approximation->a = a;
+  approximation->b = b;
+  approximation->coefficients = coefficients;
+
+  while (1) {
+    chebyshevFit(func, a, b, nbNodes, coefficients);
+
+    // The series is resolved when its two last terms are negligible, which
+    // also covers odd and even functions
+    chebyshev_real tail = fabs(coefficients[nbNodes - 1]);
+    if (nbNodes > 1) {
+      tail += fabs(coefficients[nbNodes - 2]);
+    }
+    if (tail <= 0.5 * tol) {
+      int degree = nbNodes - 1;
+      tail = 0;
+      while (degree > 0 && tail + fabs(coefficients[degree]) <= 0.5 * tol) {
+        tail += fabs(coefficients[degree]);
+        --degree;
+      }
+      approximation->degree = degree;
+      return CHEBYSHEV_SUCCESS;
+    }
+
+    if (nbNodes == maxDegree + 1) {
+      approximation->degree = maxDegree;
+      return CHEBYSHEV_NOT_CONVERGED;
+    }
+    nbNodes = 2 * nbNodes < maxDegree + 1 ? 2 * nbNodes : maxDegree + 1;
+  }
+}
+
+/**
+ * @brief Evaluates a Chebyshev series with the Clenshaw recurrence. It can be
+ * used on the tables generated by chebyshevPrintTable
+ * @param coefficients The degree + 1 coefficients of the series
+ * @param degree The degree of the series
+ * @param a Lower bound of the interval
+ * @param b Upper bound of the interval
+ * @param x The point where to evaluate the series
+ * @return The value of the series at x
+ */
+chebyshev_real chebyshevClenshaw(const chebyshev_real* coefficients,
+                                 const int degree, const chebyshev_real a,
+                                 const chebyshev_real b,
+                                 const chebyshev_real x) {
+  const chebyshev_real y = (2.0 * x - a - b) / (b - a);
+  const chebyshev_real twoY = 2.0 * y;
+  chebyshev_real next = 0;
+  chebyshev_real nextNext = 0;
+
+  for (int k = degree; k > 0; --k) {
+    chebyshev_real current = twoY * next - nextNext + coefficients[k];
+    nextNext = next;
+    next = current;
+  }
+  return y * next - nextNext + coefficients[0];
+}
+
+/**
+ * @brief Evaluates a Chebyshev approximation built by chebyshevBuild
+ * @param approximation The approximation
+ * @param x The point where to evaluate the approximation
+ * @return The value of the approximation at x
+ */
+chebyshev_real chebyshevEvaluate(const ChebyshevApproximation* approximation,
+                                 const chebyshev_real x) {
+  return chebyshevClenshaw(approximation->coefficients, approximation->degree,
+                           approximation->a, approximation->b, x);
+}
+
+/**
+ * @brief Writes the approximation as C code: a static table of coefficients
+ * and macros for its degree and interval, ready to be evaluated with
+ * chebyshevClenshaw without building the approximation at run time
+ * @param approximation The approximation
+ * @param name Name of the generated table, also used as prefix of the macros
+ * @param output The stream where to write the code
+ */
+void chebyshevPrintTable(const ChebyshevApproximation* approximation,
+                         const char* name, FILE* output) {
+  fprintf(output, "#define %s_DEGREE %d\n", name, approximation->degree);
+  fprintf(output, "#define %s_A %.17g\n", name, approximation->a);
+  fprintf(output, "#define %s_B %.17g\n", name, approximation->b);
+  fprintf(output, "static const chebyshev_real %s[%d] = {\n", name,
+          approximation->degree + 1);
+  for (int k = 0; k <= approximation->degree; ++k) {
+    fprintf(output, "    %.17g%s\n", approximation->coefficients[k],
+            k < approximation->degree ? "," : "");
+  }
+  fprintf(output, "};\n");
+}
@@ -0,0 +1,55 @@
+#ifndef CHEBYSHEV_H
+#define CHEBYSHEV_H
+
+#include <stdio.h>
+
+#ifndef chebyshev_real
+#define chebyshev_real double
+#endif
+
+#define CHEBYSHEV_SUCCESS 0
+#define CHEBYSHEV_NOT_CONVERGED 1
+#define CHEBYSHEV_INVALID_DEGREE 2
+
+// Number of Chebyshev nodes of the first fit. It is doubled until the
+// tolerance is reached
+#ifndef CHEBYSHEV_INITIAL_NODES
+#define CHEBYSHEV_INITIAL_NODES 16
+#endif
+
+typedef chebyshev_real (*chebyshev_function)(chebyshev_real);
+
+/**
+ * Approximation f(x) ~= sum(coefficients[k] * T_k(y)) for x in [a, b], with
+ * y = (2 * x - a - b) / (b - a) and T_k the Chebyshev polynomials of the
+ * first kind
+ */
+typedef struct {
+  chebyshev_real a;
+  chebyshev_real b;
+  int degree;
+  const chebyshev_real* coefficients;
+} ChebyshevApproximation;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int chebyshevBuild(chebyshev_function func, const chebyshev_real a,
+                   const chebyshev_real b, const chebyshev_real tol,
+                   const int maxDegree, chebyshev_real* coefficients,
+                   ChebyshevApproximation* approximation);
+chebyshev_real chebyshevClenshaw(const chebyshev_real* coefficients,
+                                 const int degree, const chebyshev_real a,
+                                 const chebyshev_real b,
+                                 const chebyshev_real x);
+chebyshev_real chebyshevEvaluate(const ChebyshevApproximation* approximation,
+                                 const chebyshev_real x);
+void chebyshevPrintTable(const ChebyshevApproximation* approximation,
+                         const char* name, FILE* output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
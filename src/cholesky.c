@@ -0,0 +1,337 @@
+#include "cholesky.h"
+#include "matrix.h"
+#include <math.h>
+
+/**
+ * @brief Subtract L21 * L21^T, or L21 * D1 * L21^T, from the lower part of
+ * the trailing matrix once the panel made of the columns k to blockEnd is
+ * factorized. The rows of the panel are copied contiguously so that
+ * matrixMultiply computes every update of a row with a single call
+ *
+ * @param matrix The matrix being decomposed
+ * @param size Size of the matrix
+ * @param k First column of the panel
+ * @param blockEnd Column after the last column of the panel
+ * @param scaleByDiagonal Whether to scale the panel by D, for LDL^T
+ */
+static void updateTrailingMatrix(cholesky_real* matrix, const int size,
+                                 const int k, const int blockEnd,
+                                 const int scaleByDiagonal) {
+  const int width = blockEnd - k;
+  const int nbRows = size - blockEnd;
+  if (nbRows == 0) {
+    return;
+  }
+
+  cholesky_real panel[nbRows * width];
+  cholesky_real product[nbRows];
+  for (int r = 0; r < nbRows; ++r) {
+    for (int j = 0; j < width; ++j) {
+      panel[r * width + j] = matrix[coordToIndex(blockEnd + r, k + j, size)];
+      if (scaleByDiagonal) {
+        panel[r * width + j] *= matrix[coordToIndex(k + j, k + j, size)];
+      }
+    }
+  }
+
+  for (int r = 0; r < nbRows; ++r) {
+    cholesky_real* row = &matrix[coordToIndex(blockEnd + r, 0, size)];
+    // Products of the row with the rows of the panel up to the diagonal
+    matrix_size dims[3] = {r + 1, width, 1};
+    matrixMultiply(panel, &row[k], dims, product, 0);
+    for (int col = 0; col <= r; ++col) {
+      row[blockEnd + col] -= product[col];
+    }
+  }
+}
+
+/**
+ * @brief Perform the blocked Cholesky decomposition of a symmetric positive
+ * definite matrix in place. Only the lower triangle of the matrix is read.
+ * After the call, the lower triangle contains L such that A = L * L^T and the
+ * strictly upper triangle is left untouched.
+ *
+ * @param matrix The matrix to decompose. Will contain L
+ * @param size Size of the matrix
+ * @return CHOLESKY_SUCCESS or CHOLESKY_NOT_POSITIVE_DEFINITE
+ */
+int choleskyFactorize(cholesky_real* matrix, const int size) {
+  for (int k = 0; k < size; k += CHOLESKY_BLOCK_SIZE) {
+    const int blockEnd =
+        k + CHOLESKY_BLOCK_SIZE < size ? k + CHOLESKY_BLOCK_SIZE : size;
+
+    // Factorize the panel made of the columns k to blockEnd
+    for (int j = k; j < blockEnd; ++j) {
+      cholesky_real diagonal = matrix[coordToIndex(j, j, size)];
+      if (diagonal <= 0) {
+        return CHOLESKY_NOT_POSITIVE_DEFINITE;
+      }
+      diagonal = sqrt(diagonal);
+      matrix[coordToIndex(j, j, size)] = diagonal;
+
+      for (int i = j + 1; i < size; ++i) {
+        cholesky_real* row = &matrix[coordToIndex(i, 0, size)];
+        row[j] /= diagonal;
+        const int lastCol = i < blockEnd - 1 ? i : blockEnd - 1;
+        for (int col = j + 1; col <= lastCol; ++col) {
+          row[col] -= row[j] * matrix[coordToIndex(col, j, size)];
+        }
+      }
+    }
+
+    // Update the lower part of the trailing matrix with L21 * L21^T
+    updateTrailingMatrix(matrix, size, k, blockEnd, 0);
+  }
+
+  return CHOLESKY_SUCCESS;
+}
+
+/**
+ * @brief Solve the system A * X = B from the factorization of A computed by
+ * choleskyFactorize
+ *
+ * @param lMatrix The matrix L computed by choleskyFactorize
+ * @param size Size of the matrix
+ * @param matrix The size x nbColumns matrix B. Will contain X
+ * @param nbColumns Number of right-hand sides
+ */
+void choleskySolveMany(const cholesky_real* lMatrix, const int size,
+                       cholesky_real* matrix, const int nbColumns) {
+  // Forward substitution L * Y = B
+  for (int i = 0; i < size; ++i) {
+    cholesky_real* row = &matrix[coordToIndex(i, 0, nbColumns)];
+    for (int k = 0; k < i; ++k) {
+      cholesky_real factor = lMatrix[coordToIndex(i, k, size)];
+      const cholesky_real* solved = &matrix[coordToIndex(k, 0, nbColumns)];
+      for (int j = 0; j < nbColumns; ++j) {
+        row[j] -= factor * solved[j];
+      }
+    }
+    cholesky_real diagonal = lMatrix[coordToIndex(i, i, size)];
+    for (int j = 0; j < nbColumns; ++j) {
+      row[j] /= diagonal;
+    }
+  }
+
+  // Backward substitution L^T * X = Y
+  for (int i = size - 1; i >= 0; --i) {
+    cholesky_real* row = &matrix[coordToIndex(i, 0, nbColumns)];
+    cholesky_real diagonal = lMatrix[coordToIndex(i, i, size)];
+    for (int j = 0; j < nbColumns; ++j) {
+      row[j] /= diagonal;
+    }
+    // Column i of L^T is row i of L
+    for (int k = 0; k < i; ++k) {
+      cholesky_real factor = lMatrix[coordToIndex(i, k, size)];
+      cholesky_real* other = &matrix[coordToIndex(k, 0, nbColumns)];
+      for (int j = 0; j < nbColumns; ++j) {
+        other[j] -= factor * row[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Solve the system A * x = b from the factorization of A computed by
+ * choleskyFactorize
+ *
+ * @param lMatrix The matrix L computed by choleskyFactorize
+ * @param size Size of the matrix
+ * @param vector The vector b. Will contain x
+ */
+void choleskySolve(const cholesky_real* lMatrix, const int size,
+                   cholesky_real* vector) {
+  choleskySolveMany(lMatrix, size, vector, 1);
+}
+
+/**
+ * @brief Apply a sequence of rotations to L so that it becomes the Cholesky
+ * factor of L * L^T + sign * x * x^T
+ *
+ * @param lMatrix The matrix L computed by choleskyFactorize
+ * @param vector The vector x. Its content is destroyed
+ * @param size Size of the matrix
+ * @param sign 1 for an update or -1 for a downdate
+ * @return CHOLESKY_SUCCESS or CHOLESKY_NOT_POSITIVE_DEFINITE
+ */
+static int choleskyRankOne(cholesky_real* lMatrix, cholesky_real* vector,
+                           const int size, const cholesky_real sign) {
+  for (int k = 0; k < size; ++k) {
+    cholesky_real diagonal = lMatrix[coordToIndex(k, k, size)];
+    cholesky_real squared =
+        diagonal * diagonal + sign * vector[k] * vector[k];
+    if (squared <= 0) {
+      return CHOLESKY_NOT_POSITIVE_DEFINITE;
+    }
+    cholesky_real newDiagonal = sqrt(squared);
+    cholesky_real c = newDiagonal / diagonal;
+    cholesky_real s = vector[k] / diagonal;
+    lMatrix[coordToIndex(k, k, size)] = newDiagonal;
+
+    for (int i = k + 1; i < size; ++i) {
+      cholesky_real* element = &lMatrix[coordToIndex(i, k, size)];
+      *element = (*element + sign * s * vector[i]) / c;
+      vector[i] = c * vector[i] - s * *element;
+    }
+  }
+
+  return CHOLESKY_SUCCESS;
+}
+
+/**
+ * @brief Update the Cholesky factor L of A in O(n^2) so that it becomes the
+ * factor of A + x * x^T
+ *
+ * @param lMatrix The matrix L computed by choleskyFactorize
+ * @param vector The vector x. Its content is destroyed
+ * @param size Size of the matrix
+ */
+void choleskyUpdate(cholesky_real* lMatrix, cholesky_real* vector,
+                    const int size) {
+  choleskyRankOne(lMatrix, vector, size, 1);
+}
+
+/**
+ * @brief Downdate the Cholesky factor L of A in O(n^2) so that it becomes the
+ * factor of A - x * x^T. On failure, L is left partially modified
+ *
+ * @param lMatrix The matrix L computed by choleskyFactorize
+ * @param vector The vector x. Its content is destroyed
+ * @param size Size of the matrix
+ * @return CHOLESKY_SUCCESS or CHOLESKY_NOT_POSITIVE_DEFINITE if A - x * x^T
+ * is not positive definite
+ */
+int choleskyDowndate(cholesky_real* lMatrix, cholesky_real* vector,
+                     const int size) {
+  return choleskyRankOne(lMatrix, vector, size, -1);
+}
+
+/**
+ * @brief Perform the blocked LDL^T decomposition of a symmetric matrix in
+ * place, without square roots and without pivoting. Only the lower triangle
+ * of the matrix is read. After the call, the strictly lower triangle contains
+ * L (whose diagonal is made of 1), the diagonal contains D and the strictly
+ * upper triangle is left untouched.
+ *
+ * @param matrix The matrix to decompose. Will contain L and D
+ * @param size Size of the matrix
+ * @return CHOLESKY_SUCCESS or CHOLESKY_SINGULAR if a null pivot is found
+ */
+int LDLTFactorize(cholesky_real* matrix, const int size) {
+  for (int k = 0; k < size; k += CHOLESKY_BLOCK_SIZE) {
+    const int blockEnd =
+        k + CHOLESKY_BLOCK_SIZE < size ? k + CHOLESKY_BLOCK_SIZE : size;
+
+    // Factorize the panel made of the columns k to blockEnd
+    for (int j = k; j < blockEnd; ++j) {
+      cholesky_real diagonal = matrix[coordToIndex(j, j, size)];
+      if (diagonal == 0) {
+        return CHOLESKY_SINGULAR;
+      }
+
+      for (int i = j + 1; i < size; ++i) {
+        cholesky_real* row = &matrix[coordToIndex(i, 0, size)];
+        row[j] /= diagonal;
+        const int lastCol = i < blockEnd - 1 ? i : blockEnd - 1;
+        for (int col = j + 1; col <= lastCol; ++col) {
+          row[col] -= row[j] * diagonal * matrix[coordToIndex(col, j, size)];
+        }
+      }
+    }
+
+    // Update the lower part of the trailing matrix with L21 * D1 * L21^T
+    updateTrailingMatrix(matrix, size, k, blockEnd, 1);
+  }
+
+  return CHOLESKY_SUCCESS;
+}
+
+/**
+ * @brief Solve the system A * X = B from the factorization of A computed by
+ * LDLTFactorize
+ *
+ * @param ldlMatrix The L and D matrices computed by LDLTFactorize
+ * @param size Size of the matrix
+ * @param matrix The size x nbColumns matrix B. Will contain X
+ * @param nbColumns Number of right-hand sides
+ */
+void LDLTSolveMany(const cholesky_real* ldlMatrix, const int size,
+                   cholesky_real* matrix, const int nbColumns) {
+  // Forward substitution L * Y = B
+  for (int i = 1; i < size; ++i) {
+    cholesky_real* row = &matrix[coordToIndex(i, 0, nbColumns)];
+    for (int k = 0; k < i; ++k) {
+      cholesky_real factor = ldlMatrix[coordToIndex(i, k, size)];
+      const cholesky_real* solved = &matrix[coordToIndex(k, 0, nbColumns)];
+      for (int j = 0; j < nbColumns; ++j) {
+        row[j] -= factor * solved[j];
+      }
+    }
+  }
+
+  // Diagonal D * Z = Y and backward substitution L^T * X = Z
+  for (int i = size - 1; i >= 0; --i) {
+    cholesky_real* row = &matrix[coordToIndex(i, 0, nbColumns)];
+    cholesky_real diagonal = ldlMatrix[coordToIndex(i, i, size)];
+    for (int j = 0; j < nbColumns; ++j) {
+      row[j] /= diagonal;
+    }
+  }
+  for (int i = size - 1; i > 0; --i) {
+    const cholesky_real* row = &matrix[coordToIndex(i, 0, nbColumns)];
+    for (int k = 0; k < i; ++k) {
+      cholesky_real factor = ldlMatrix[coordToIndex(i, k, size)];
+      cholesky_real* other = &matrix[coordToIndex(k, 0, nbColumns)];
+      for (int j = 0; j < nbColumns; ++j) {
+        other[j] -= factor * row[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief Solve the system A * x = b from the factorization of A computed by
+ * LDLTFactorize
+ *
+ * @param ldlMatrix The L and D matrices computed by LDLTFactorize
+ * @param size Size of the matrix
+ * @param vector The vector b. Will contain x
+ */
+void LDLTSolve(const cholesky_real* ldlMatrix, const int size,
+               cholesky_real* vector) {
+  LDLTSolveMany(ldlMatrix, size, vector, 1);
+}
+
+/**
+ * @brief Update the LDL^T factorization of A in O(n^2) so that it becomes the
+ * factorization of A + alpha * x * x^T. A negative alpha performs a downdate.
+ * On failure, the factorization is left partially modified
+ *
+ * @param ldlMatrix The L and D matrices computed by LDLTFactorize
+ * @param vector The vector x. Its content is destroyed
+ * @param size Size of the matrix
+ * @param alpha Scale of the rank-1 modification
+ * @return CHOLESKY_SUCCESS or CHOLESKY_SINGULAR if a null pivot appears
+ */
+int LDLTRankOneUpdate(cholesky_real* ldlMatrix, cholesky_real* vector,
+                      const int size, cholesky_real alpha) {
+  for (int k = 0; k < size; ++k) {
+    cholesky_real* diagonal = &ldlMatrix[coordToIndex(k, k, size)];
+    cholesky_real p = vector[k];
+    cholesky_real newDiagonal = *diagonal + alpha * p * p;
+    if (newDiagonal == 0) {
+      return CHOLESKY_SINGULAR;
+    }
+    cholesky_real beta = alpha * p / newDiagonal;
+    alpha *= *diagonal / newDiagonal;
+    *diagonal = newDiagonal;
+
+    for (int i = k + 1; i < size; ++i) {
+      cholesky_real* element = &ldlMatrix[coordToIndex(i, k, size)];
+      vector[i] -= p * *element;
+      *element += beta * vector[i];
+    }
+  }
+
+  return CHOLESKY_SUCCESS;
+}
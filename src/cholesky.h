@@ -0,0 +1,41 @@
+#ifndef CHOLESKY_H
+#define CHOLESKY_H
+
+typedef double cholesky_real;
+
+#define CHOLESKY_SUCCESS 0
+#define CHOLESKY_NOT_POSITIVE_DEFINITE 1
+#define CHOLESKY_SINGULAR 2
+
+// Number of columns factorized together before updating the trailing matrix
+#ifndef CHOLESKY_BLOCK_SIZE
+#define CHOLESKY_BLOCK_SIZE 32
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int choleskyFactorize(cholesky_real* matrix, const int size);
+void choleskySolve(const cholesky_real* lMatrix, const int size,
+                   cholesky_real* vector);
+void choleskySolveMany(const cholesky_real* lMatrix, const int size,
+                       cholesky_real* matrix, const int nbColumns);
+void choleskyUpdate(cholesky_real* lMatrix, cholesky_real* vector,
+                    const int size);
+int choleskyDowndate(cholesky_real* lMatrix, cholesky_real* vector,
+                     const int size);
+
+int LDLTFactorize(cholesky_real* matrix, const int size);
+void LDLTSolve(const cholesky_real* ldlMatrix, const int size,
+               cholesky_real* vector);
+void LDLTSolveMany(const cholesky_real* ldlMatrix, const int size,
+                   cholesky_real* matrix, const int nbColumns);
+int LDLTRankOneUpdate(cholesky_real* ldlMatrix, cholesky_real* vector,
+                      const int size, cholesky_real alpha);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
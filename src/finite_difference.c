@@ -1,9 +1,28 @@
 #include "finite_difference.h"
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
+/// @brief Computes the steps taken forward and backward along each dimension.
+/// It is imperative to choose h so that x and x + h differ by an exactly
+/// representable number, see:
+/// http://www.it.uom.gr/teaching/linearalgebra/NumericalRecipiesInC/c5-7.pdf
+static void computeSteps(const real point[], real h_next[], real h_prev[],
+                         int n, real eps) {
+  volatile real temp;
+  for (int i = 0; i < n; i++) {
+    temp = point[i] + eps;
+    h_next[i] = temp - point[i];
+
+    temp = point[i] - eps;
+    h_prev[i] = point[i] - temp;
+  }
+}
+
 /// @brief Approximates the gradient of a function using the first order finite
-/// difference method.
+/// difference method. The base point is evaluated only once, and when compiled
+/// with OpenMP the perturbed points are spread over threads for functions of
+/// at least FD_PARALLEL_MIN_SIZE dimensions.
 
 /// @param func The function for which to approximate the gradient
 /// @param point The point at which to appriximate the gradient
@@ -16,51 +35,471 @@
 /// Central)
 void gradientApproximation(function func, real point[], real grad[], int n,
                            real eps, approximationType type) {
-  // It is imperative to choose h so that x and x + h differ by an exactly
-  // representable number
-  // see:
-  // http://www.it.uom.gr/teaching/linearalgebra/NumericalRecipiesInC/c5-7.pdf
   real h_next[n];
   real h_prev[n];
-  volatile real temp;
+  computeSteps(point, h_next, h_prev, n, eps);
+
+  // The base point is shared by every one-sided difference
+  const real base = type == Central ? 0 : func(point);
+
+  // Every perturbation is independent, func must be thread safe with OpenMP
+#ifdef _OPENMP
+#pragma omp parallel if (n >= FD_PARALLEL_MIN_SIZE)
+#endif
+  {
+    real shifted[n];
+    memcpy(shifted, point, n * sizeof(real));
+
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (int i = 0; i < n; i++) {
+      if (type == Forward) {
+        shifted[i] = point[i] + h_next[i];
+        grad[i] = (func(shifted) - base) / h_next[i];
+      } else if (type == Backward) {
+        shifted[i] = point[i] - h_prev[i];
+        grad[i] = (base - func(shifted)) / h_prev[i];
+      } else {
+        shifted[i] = point[i] + h_next[i];
+        real next = func(shifted);
+        shifted[i] = point[i] - h_prev[i];
+        grad[i] = (next - func(shifted)) / (h_prev[i] + h_next[i]);
+      }
+      shifted[i] = point[i];
+    }
+  }
+}
+
+/// @brief Approximates the gradient of a function using the first order finite
+/// difference method, with a function evaluating several points per call.
+/// The perturbed points are given to func by groups of at most FD_BATCH_SIZE,
+/// so that it can evaluate them in parallel or with vector instructions, and
+/// of at most FD_BATCH_MAX_ELEMENTS coordinates. The base point is evaluated
+/// only once.
+
+/// @param func The batched function for which to approximate the gradient
+/// @param point The point at which to approximate the gradient
+/// @param grad Return parameter containing the approximated gradient
+/// @param n Number of dimensions of the function
+/// @param eps Size of the step taken away from point for the approximation.
+/// @param type Type of finite difference approximation (Forward, Backward or
+/// Central)
+void gradientApproximationBatch(function_batch func, real point[],
+                                real grad[], int n, real eps,
+                                approximationType type) {
+  // Bound the stack used by the perturbed points for large n
+  int batchSize = FD_BATCH_MAX_ELEMENTS / n;
+  if (batchSize > FD_BATCH_SIZE) {
+    batchSize = FD_BATCH_SIZE;
+  } else if (batchSize < 1) {
+    batchSize = 1;
+  }
+
+  real h_next[n];
+  real h_prev[n];
+  real points[batchSize * n];
+  real values[batchSize];
+  real base = 0;
+  computeSteps(point, h_next, h_prev, n, eps);
+
+  // Evaluation 0 is the base point for one-sided differences. For central
+  // differences, evaluations 2 * i and 2 * i + 1 are the points shifted
+  // forward and backward along dimension i
+  const int first = type == Central ? 0 : -1;
+  const int last = type == Central ? 2 * n : n;
+
+  for (int start = first; start < last; start += batchSize) {
+    const int count = last - start < batchSize ? last - start : batchSize;
+
+    for (int k = 0; k < count; k++) {
+      real* shifted = &points[k * n];
+      int evaluation = start + k;
+      memcpy(shifted, point, n * sizeof(real));
+      if (evaluation < 0) {
+        continue;
+      }
+      if (type == Forward) {
+        shifted[evaluation] += h_next[evaluation];
+      } else if (type == Backward) {
+        shifted[evaluation] -= h_prev[evaluation];
+      } else if (evaluation % 2 == 0) {
+        shifted[evaluation / 2] += h_next[evaluation / 2];
+      } else {
+        shifted[evaluation / 2] -= h_prev[evaluation / 2];
+      }
+    }
+
+    func(points, values, count, n);
+
+    for (int k = 0; k < count; k++) {
+      int evaluation = start + k;
+      if (evaluation < 0) {
+        base = values[k];
+      } else if (type == Forward) {
+        grad[evaluation] = (values[k] - base) / h_next[evaluation];
+      } else if (type == Backward) {
+        grad[evaluation] = (base - values[k]) / h_prev[evaluation];
+      } else if (evaluation % 2 == 0) {
+        // Keep f(x + h) until f(x - h) is known
+        grad[evaluation / 2] = values[k];
+      } else {
+        int i = evaluation / 2;
+        grad[i] = (grad[i] - values[k]) / (h_prev[i] + h_next[i]);
+      }
+    }
+  }
+}
+
+/// @brief Approximates the gradient of a function with central differences
+/// improved by Richardson extrapolation. The step is halved levels - 1 times
+/// and the tableau of differences removes the error terms in h^2, h^4, ...
+/// Starting from a larger eps than with gradientApproximation, for example
+/// 1e-2, avoids the round-off errors of tiny steps.
+
+/// @param func The function for which to approximate the gradient
+/// @param point The point at which to approximate the gradient
+/// @param grad Return parameter containing the approximated gradient
+/// @param n Number of dimensions of the function
+/// @param eps Size of the initial step
+/// @param levels Number of steps, from 1 to FD_MAX_RICHARDSON_LEVELS
+/// @param error Return parameter containing an estimation of the error of each
+/// element of the gradient. Can be NULL
+void gradientRichardson(function func, real point[], real grad[], int n,
+                        real eps, int levels, real error[]) {
+  real tableau[FD_MAX_RICHARDSON_LEVELS][FD_MAX_RICHARDSON_LEVELS];
+  real shifted[n];
+  memcpy(shifted, point, n * sizeof(real));
+  if (levels > FD_MAX_RICHARDSON_LEVELS) {
+    levels = FD_MAX_RICHARDSON_LEVELS;
+  } else if (levels < 1) {
+    levels = 1;
+  }
+
   for (int i = 0; i < n; i++) {
-    temp = point[i] + eps;
-    h_next[i] = temp - point[i];
+    real step = eps;
+    for (int k = 0; k < levels; k++) {
+      real h_next;
+      real h_prev;
+      computeSteps(&point[i], &h_next, &h_prev, 1, step);
 
-    temp = point[i] - eps;
-    h_prev[i] = point[i] - temp;
+      shifted[i] = point[i] + h_next;
+      real next = func(shifted);
+      shifted[i] = point[i] - h_prev;
+      tableau[k][0] = (next - func(shifted)) / (h_prev + h_next);
+      shifted[i] = point[i];
+
+      // Halving the step divides the error in h^(2j) by 4^j
+      real factor = 4;
+      for (int j = 1; j <= k; j++) {
+        tableau[k][j] = tableau[k][j - 1] +
+                        (tableau[k][j - 1] - tableau[k - 1][j - 1]) /
+                            (factor - 1);
+        factor *= 4;
+      }
+      step /= 2;
+    }
+
+    grad[i] = tableau[levels - 1][levels - 1];
+    if (error != NULL) {
+      error[i] = levels > 1 ? fabs(grad[i] - tableau[levels - 2][levels - 2])
+                            : fabs(grad[i]);
+    }
+  }
+}
+
+/// @brief Evaluates a vector function at the point shifted along every
+/// dimension j for which group[j] is equal to color, or only along the
+/// dimension color when group is NULL. next and prev receive the values
+/// forward and backward of the point, or base for one-sided differences.
+static void shiftedDifference(vector_function func, real point[],
+                              real shifted[], const real h_next[],
+                              const real h_prev[], const int group[],
+                              int color, int n, const real base[], int m,
+                              real next[], real prev[],
+                              approximationType type) {
+  const int first = group == NULL ? color : 0;
+  const int last = group == NULL ? color + 1 : n;
+
+  if (type == Backward) {
+    memcpy(next, base, m * sizeof(real));
+  } else {
+    for (int j = first; j < last; j++) {
+      if (group == NULL || group[j] == color) {
+        shifted[j] = point[j] + h_next[j];
+      }
+    }
+    func(shifted, next);
   }
 
   if (type == Forward) {
-    real next[n];
-    memcpy(next, point, n * sizeof(real));
+    memcpy(prev, base, m * sizeof(real));
+  } else {
+    for (int j = first; j < last; j++) {
+      if (group == NULL || group[j] == color) {
+        shifted[j] = point[j] - h_prev[j];
+      }
+    }
+    func(shifted, prev);
+  }
 
-    for (int i = 0; i < n; i++) {
-      next[i] += h_next[i];
-      grad[i] = (func(next) - func(point)) / h_next[i];
-      next[i] -= h_next[i];
+  for (int j = first; j < last; j++) {
+    shifted[j] = point[j];
+  }
+}
+
+/// @brief Approximates the Jacobian of a vector function using the first order
+/// finite difference method, with one evaluation per dimension, plus the base
+/// point for one-sided differences.
+
+/// @param func The function from n to m dimensions to derive
+/// @param point The point at which to approximate the Jacobian
+/// @param jacobian Return parameter containing the m x n Jacobian in row-major
+/// order: jacobian[i * n + j] is the derivative of output i along dimension j
+/// @param n Number of dimensions of the input
+/// @param m Number of dimensions of the output
+/// @param eps Size of the step taken away from point for the approximation
+/// @param type Type of finite difference approximation (Forward, Backward or
+/// Central)
+void jacobianApproximation(vector_function func, real point[],
+                           real jacobian[], int n, int m, real eps,
+                           approximationType type) {
+  real h_next[n];
+  real h_prev[n];
+  real shifted[n];
+  real base[m];
+  real next[m];
+  real prev[m];
+  computeSteps(point, h_next, h_prev, n, eps);
+  memcpy(shifted, point, n * sizeof(real));
+  if (type != Central) {
+    func(point, base);
+  }
+
+  for (int j = 0; j < n; j++) {
+    shiftedDifference(func, point, shifted, h_next, h_prev, NULL, j, n, base,
+                      m, next, prev, type);
+    const real step = (type != Backward ? h_next[j] : 0) +
+                      (type != Forward ? h_prev[j] : 0);
+    for (int i = 0; i < m; i++) {
+      jacobian[i * n + j] = (next[i] - prev[i]) / step;
     }
-  } else if (type == Backward) {
-    real prev[n];
-    memcpy(prev, point, n * sizeof(real));
+  }
+}
 
-    for (int i = 0; i < n; i++) {
-      prev[i] -= h_prev[i];
-      grad[i] = (func(point) - func(prev)) / h_prev[i];
-      prev[i] += h_prev[i];
+/// @brief Approximates the Hessian of a function from its values, with central
+/// differences of second order accuracy: three points on the diagonal and four
+/// points around each off diagonal element. It needs 1 + 2n + 2n(n - 1)
+/// evaluations, and a larger step than for gradients, for example 1e-4, limits
+/// the round-off errors.
+
+/// @param func The function for which to approximate the Hessian
+/// @param point The point at which to approximate the Hessian
+/// @param hessian Return parameter containing the symmetric n x n Hessian
+/// @param n Number of dimensions of the function
+/// @param eps Size of the step taken away from point for the approximation
+void hessianApproximation(function func, real point[], real hessian[], int n,
+                          real eps) {
+  real h_next[n];
+  real h_prev[n];
+  real shifted[n];
+  computeSteps(point, h_next, h_prev, n, eps);
+  memcpy(shifted, point, n * sizeof(real));
+  const real base = func(point);
+
+  for (int i = 0; i < n; i++) {
+    shifted[i] = point[i] + h_next[i];
+    real forward = func(shifted);
+    shifted[i] = point[i] - h_prev[i];
+    real backward = func(shifted);
+    shifted[i] = point[i];
+
+    // Second difference with unequal steps
+    hessian[i * n + i] = 2 *
+                         ((forward - base) / h_next[i] -
+                          (base - backward) / h_prev[i]) /
+                         (h_next[i] + h_prev[i]);
+  }
+
+  // Cross difference on the four corners around the point. The terms in the
+  // second derivatives along i and j cancel out even with unequal steps
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) {
+      real corners = 0;
+      for (int k = 0; k < 4; k++) {
+        shifted[i] = point[i] + (k & 1 ? -h_prev[i] : h_next[i]);
+        shifted[j] = point[j] + (k & 2 ? -h_prev[j] : h_next[j]);
+        corners += (k == 1 || k == 2 ? -1 : 1) * func(shifted);
+      }
+      shifted[i] = point[i];
+      shifted[j] = point[j];
+
+      hessian[i * n + j] =
+          corners / ((h_next[i] + h_prev[i]) * (h_next[j] + h_prev[j]));
+      hessian[j * n + i] = hessian[i * n + j];
     }
-  } else {
-    real next[n];
-    real prev[n];
-    memcpy(next, point, n * sizeof(real));
-    memcpy(prev, point, n * sizeof(real));
+  }
+}
 
-    for (int i = 0; i < n; i++) {
-      next[i] += h_next[i];
-      prev[i] -= h_prev[i];
-      grad[i] = (func(next) - func(prev)) / (h_prev[i] + h_next[i]);
-      prev[i] += h_prev[i];
-      next[i] -= h_next[i];
+/// @brief Groups the columns of a sparse matrix so that the columns of a group
+/// have no nonzero in a common row (Curtis-Powell-Reid). All the columns of a
+/// group can then be derived with a single shifted evaluation. The columns are
+/// colored greedily in order, so a matrix of bandwidth b needs about 2b + 1
+/// groups whatever its size.
+
+/// @param pattern The sparsity pattern of the matrix
+/// @param colors Return parameter containing the group of each of the
+/// nbColumns columns, from 0 to the number of groups minus 1
+/// @return The number of groups
+int colorColumns(const SparsityPattern* pattern, int colors[]) {
+  const int n = pattern->nbColumns;
+  const int m = pattern->nbRows;
+  const int* rowStart = pattern->rowStart;
+  const int* columns = pattern->columns;
+  int columnStart[n + 1];
+  int rows[rowStart[m] > 0 ? rowStart[m] : 1];
+  int forbidden[n];
+  int nbColors = 0;
+
+  // Transposed pattern, to find the rows of each column
+  memset(columnStart, 0, (n + 1) * sizeof(int));
+  for (int k = 0; k < rowStart[m]; k++) {
+    columnStart[columns[k] + 1]++;
+  }
+  for (int j = 0; j < n; j++) {
+    columnStart[j + 1] += columnStart[j];
+    forbidden[j] = columnStart[j];
+  }
+  for (int i = 0; i < m; i++) {
+    for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+      rows[forbidden[columns[k]]++] = i;
+    }
+  }
+
+  for (int j = 0; j < n; j++) {
+    colors[j] = -1;
+    forbidden[j] = -1;
+  }
+
+  for (int j = 0; j < n; j++) {
+    // Mark the groups of the colored columns sharing a row with column j
+    for (int k = columnStart[j]; k < columnStart[j + 1]; k++) {
+      int row = rows[k];
+      for (int l = rowStart[row]; l < rowStart[row + 1]; l++) {
+        if (colors[columns[l]] >= 0) {
+          forbidden[colors[columns[l]]] = j;
+        }
+      }
+    }
+
+    int color = 0;
+    while (color < nbColors && forbidden[color] == j) {
+      color++;
+    }
+    colors[j] = color;
+    if (color == nbColors) {
+      nbColors++;
+    }
+  }
+
+  return nbColors;
+}
+
+/// @brief Approximates the nonzeros of a sparse Jacobian using the first order
+/// finite difference method. The columns of a group given by colorColumns are
+/// shifted together, so the number of evaluations depends on the number of
+/// groups instead of the number of dimensions.
+
+/// @param func The function from nbColumns to nbRows dimensions to derive
+/// @param point The point at which to approximate the Jacobian
+/// @param pattern The sparsity pattern of the Jacobian
+/// @param colors The group of each column, computed by colorColumns
+/// @param nbColors The number of groups
+/// @param values Return parameter containing the nonzeros of the Jacobian, in
+/// the order of pattern->columns
+/// @param eps Size of the step taken away from point for the approximation
+/// @param type Type of finite difference approximation (Forward, Backward or
+/// Central)
+void sparseJacobianApproximation(vector_function func, real point[],
+                                 const SparsityPattern* pattern,
+                                 const int colors[], int nbColors,
+                                 real values[], real eps,
+                                 approximationType type) {
+  const int n = pattern->nbColumns;
+  const int m = pattern->nbRows;
+  real h_next[n];
+  real h_prev[n];
+  real shifted[n];
+  real base[m];
+  real next[m];
+  real prev[m];
+  computeSteps(point, h_next, h_prev, n, eps);
+  memcpy(shifted, point, n * sizeof(real));
+  if (type != Central) {
+    func(point, base);
+  }
+
+  for (int color = 0; color < nbColors; color++) {
+    shiftedDifference(func, point, shifted, h_next, h_prev, colors, color, n,
+                      base, m, next, prev, type);
+
+    // Each row has at most one nonzero in the group
+    for (int i = 0; i < m; i++) {
+      for (int k = pattern->rowStart[i]; k < pattern->rowStart[i + 1]; k++) {
+        int j = pattern->columns[k];
+        if (colors[j] == color) {
+          const real step = (type != Backward ? h_next[j] : 0) +
+                            (type != Forward ? h_prev[j] : 0);
+          values[k] = (next[i] - prev[i]) / step;
+        }
+      }
+    }
+  }
+}
+
+/// @brief Approximates the nonzeros of a sparse Hessian as the Jacobian of the
+/// gradient with central differences, then averages the symmetric elements.
+
+/// @param gradient The gradient of the function, from n to n dimensions
+/// @param point The point at which to approximate the Hessian
+/// @param pattern The symmetric sparsity pattern of the Hessian, with the
+/// columns of every row sorted in increasing order
+/// @param colors The group of each column, computed by colorColumns
+/// @param nbColors The number of groups
+/// @param values Return parameter containing the nonzeros of the Hessian, in
+/// the order of pattern->columns
+/// @param eps Size of the step taken away from point for the approximation
+void sparseHessianApproximation(vector_function gradient, real point[],
+                                const SparsityPattern* pattern,
+                                const int colors[], int nbColors,
+                                real values[], real eps) {
+  const int* rowStart = pattern->rowStart;
+  const int* columns = pattern->columns;
+  sparseJacobianApproximation(gradient, point, pattern, colors, nbColors,
+                              values, eps, Central);
+
+  for (int i = 0; i < pattern->nbRows; i++) {
+    for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+      int j = columns[k];
+      if (j <= i) {
+        continue;
+      }
+
+      // Binary search of the element (j, i)
+      int low = rowStart[j];
+      int high = rowStart[j + 1] - 1;
+      while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (columns[middle] < i) {
+          low = middle + 1;
+        } else {
+          high = middle;
+        }
+      }
+      if (low <= high && columns[low] == i) {
+        values[k] = 0.5 * (values[k] + values[low]);
+        values[low] = values[k];
+      }
     }
   }
 }
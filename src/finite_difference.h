@@ -1,20 +1,85 @@
+#ifndef FINITE_DIFFERENCE_H
+#define FINITE_DIFFERENCE_H
+
 #ifndef REAL_NUMBER
 #define REAL_NUMBER double
 #endif
 
+// Maximum number of perturbed points given at once to a batched function
+#ifndef FD_BATCH_SIZE
+#define FD_BATCH_SIZE 32
+#endif
+
+// Maximum number of coordinates of the perturbed points kept on the stack by
+// gradientApproximationBatch. Functions of many dimensions get fewer points
+// per call, and at least one
+#ifndef FD_BATCH_MAX_ELEMENTS
+#define FD_BATCH_MAX_ELEMENTS 1024
+#endif
+
+// Minimum number of dimensions under which OpenMP threads are not used
+#ifndef FD_PARALLEL_MIN_SIZE
+#define FD_PARALLEL_MIN_SIZE 8
+#endif
+
+// Maximum number of step halvings of the Richardson extrapolation
+#ifndef FD_MAX_RICHARDSON_LEVELS
+#define FD_MAX_RICHARDSON_LEVELS 10
+#endif
+
 typedef REAL_NUMBER real;
 
 typedef real (*function)(real[]);
 
+// Evaluates the function at count points of n dimensions stored one after the
+// other in points, and writes the count results in values
+typedef void (*function_batch)(real points[], real values[], int count, int n);
+
 typedef enum { Forward, Backward, Central } approximationType;
 
+// Function from n to m dimensions writing its m results in output, such as a
+// vector of residuals or a gradient
+typedef void (*vector_function)(real input[], real output[]);
+
+// Sparsity pattern of a nbRows x nbColumns matrix in compressed sparse row
+// format: the columns of the nonzeros of row i are columns[rowStart[i]] to
+// columns[rowStart[i + 1] - 1], and rowStart[0] is 0
+typedef struct {
+  int nbRows;
+  int nbColumns;
+  const int* rowStart;
+  const int* columns;
+} SparsityPattern;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void gradientApproximation(function func, real point[], real grad[], int n,
                            real eps, approximationType type);
+void gradientApproximationBatch(function_batch func, real point[],
+                                real grad[], int n, real eps,
+                                approximationType type);
+void gradientRichardson(function func, real point[], real grad[], int n,
+                        real eps, int levels, real error[]);
+void jacobianApproximation(vector_function func, real point[],
+                           real jacobian[], int n, int m, real eps,
+                           approximationType type);
+void hessianApproximation(function func, real point[], real hessian[], int n,
+                          real eps);
+int colorColumns(const SparsityPattern* pattern, int colors[]);
+void sparseJacobianApproximation(vector_function func, real point[],
+                                 const SparsityPattern* pattern,
+                                 const int colors[], int nbColors,
+                                 real values[], real eps,
+                                 approximationType type);
+void sparseHessianApproximation(vector_function gradient, real point[],
+                                const SparsityPattern* pattern,
+                                const int colors[], int nbColors,
+                                real values[], real eps);
 
 #ifdef __cplusplus
 }
 #endif
+
+#endif
@@ -0,0 +1,26 @@
+#include "finite_difference_complex.h"
+
+/// @brief Approximates the gradient of a function with the complex-step
+/// method: df/dx_i = Im(f(x + i * h * e_i)) / h. There is no subtraction, so
+/// the step can be tiny, for example 1e-20, and the gradient is accurate to
+/// the machine precision. The function must be written with complex arithmetic
+/// and be analytic, without abs, comparisons or conjugates of its inputs.
+
+/// @param func The complex function for which to approximate the gradient
+/// @param point The point at which to approximate the gradient
+/// @param grad Return parameter containing the approximated gradient
+/// @param n Number of dimensions of the function
+/// @param h Size of the imaginary step
+void gradientComplexStep(complex_function func, real point[], real grad[],
+                         int n, real h) {
+  complex_real shifted[n];
+  for (int i = 0; i < n; i++) {
+    shifted[i] = point[i];
+  }
+
+  for (int i = 0; i < n; i++) {
+    shifted[i] = point[i] + h * I;
+    grad[i] = cimag(func(shifted)) / h;
+    shifted[i] = point[i];
+  }
+}
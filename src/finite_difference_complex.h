@@ -0,0 +1,26 @@
+#ifndef FINITE_DIFFERENCE_COMPLEX_H
+#define FINITE_DIFFERENCE_COMPLEX_H
+
+// Complex-step differentiation needs C99 complex arithmetic, which is not
+// available on every toolchain, and <complex.h> defines the I macro. It is
+// kept out of finite_difference.h and 1chipml.h, include it explicitly.
+#include "finite_difference.h"
+#include <complex.h>
+
+typedef REAL_NUMBER _Complex complex_real;
+
+// Function accepting complex inputs, analytic in each of its variables
+typedef complex_real (*complex_function)(complex_real[]);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void gradientComplexStep(complex_function func, real point[], real grad[],
+                         int n, real h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
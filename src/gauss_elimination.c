@@ -2,86 +2,106 @@
 
 #include "gauss_elimination.h"
 
+/* The routine below implements the Gauss elimination method with partial
+   pivoting to solve a system of n linear equations of the type A*x=b.
+   It works in place on a caller-provided contiguous buffer and does not
+   allocate any memory, so it can be called in real-time loops.
+   Inputs: n, augmented[] the n*(n+1) row-major matrix [A, b], which is
+           overwritten by the elimination.
+   Outputs: x[] the n elements solution array provided by the caller.
+   Returns GAUSS_SUCCESS, or GAUSS_SINGULAR if a zero pivot is found. */
+int gauss_elimination_solve(int n, gauss_real* augmented, gauss_real* x) {
+
+  /* Variables declarations */
+  int i, j, k;
+  int pivot;
+  const int columns = n + 1;
+  gauss_real r;
+  gauss_real tmp;
+  gauss_real* row_i;
+  gauss_real* row_j;
+
+  /* Apply the Gauss elimination method */
+  for (i = 0; i < n; i++) {
+    /* Select the row with the largest pivot in column i */
+    pivot = i;
+    for (j = i + 1; j < n; j++) {
+      if (fabs(augmented[j * columns + i]) >
+          fabs(augmented[pivot * columns + i]))
+        pivot = j;
+    }
+    if (augmented[pivot * columns + i] == 0)
+      return GAUSS_SINGULAR;
+
+    /* Swap the remaining part of the rows, the left part is already zero */
+    row_i = &augmented[i * columns];
+    if (pivot != i) {
+      row_j = &augmented[pivot * columns];
+      for (k = i; k < columns; k++) {
+        tmp = row_i[k];
+        row_i[k] = row_j[k];
+        row_j[k] = tmp;
+      }
+    }
+
+    for (j = i + 1; j < n; j++) {
+      row_j = &augmented[j * columns];
+      r = row_j[i] / row_i[i];
+      row_j[i] = 0;
+      for (k = i + 1; k < columns; k++)
+        row_j[k] = row_j[k] - r * row_i[k];
+    }
+  }
+
+  /* Apply back-tracking */
+  for (i = n - 1; i >= 0; i--) {
+    row_i = &augmented[i * columns];
+    x[i] = row_i[n];
+    for (j = i + 1; j < n; j++)
+      x[i] = x[i] - row_i[j] * x[j];
+    x[i] = x[i] / row_i[i];
+  }
+
+  return GAUSS_SUCCESS;
+}
+
 /* The routine below implements the Gauss elimination method
    to solve a system of n linear equations of the type matrix_a*x=vector_b.
+   It copies the system into a temporary buffer and calls
+   gauss_elimination_solve, prefer the latter to avoid any allocation.
    Inputs: n, matrix_a[][], vector_b[].
-   Outputs: pointer to the solution array x[] */
+   Outputs: pointer to the solution array x[], to be freed by the caller,
+            or NULL if the system is singular or the allocation failed */
 gauss_real* gauss_elimination(int n, gauss_real** matrix_a,
                               gauss_real* vector_b) {
 
   /* Variables and pointers declarations */
-  int i, j, k;
-  int sum;
-  int max;
-  int indx;
-  int count = 0;
-  gauss_real r;
+  int i, j;
   gauss_real* x;
-  gauss_real* tmp;
-  gauss_real** a;
+  gauss_real* a;
 
   /* Memory allocation */
-  a = (gauss_real**)malloc(n * sizeof(gauss_real*));
-  for (i = 0; i < n; i++)
-    a[i] = (gauss_real*)malloc((n + 1) * sizeof(gauss_real));
-
+  a = (gauss_real*)malloc(n * (n + 1) * sizeof(gauss_real));
   x = (gauss_real*)malloc(n * sizeof(gauss_real));
+  if (a == NULL || x == NULL) {
+    free(a);
+    free(x);
+    return NULL;
+  }
 
-  /* Load the matrix a[][], the matrix a[][] is an n*(n+1) matrix which reads
+  /* Load the matrix a[], the matrix a[] is an n*(n+1) matrix which reads
    * [matrix_a, matrix_b] */
   for (i = 0; i < n; i++) {
     for (j = 0; j < n; j++)
-      a[i][j] = matrix_a[i][j];
-    a[i][j] = vector_b[i];
+      a[i * (n + 1) + j] = matrix_a[i][j];
+    a[i * (n + 1) + n] = vector_b[i];
   }
 
-  /* Check if the equations satisfy the diagonal dominance condition */
-  i = 0;
-  while (i < n) {
-    sum = 0;
-    max = abs(a[i][i]);
-    for (j = 0; j < n; j++) {
-      if (i != j) {
-        sum = sum + abs(a[i][j]);
-        if (abs(a[i][j]) >= max) {
-          max = abs(a[i][j]);
-          indx = j;
-        }
-      }
-    }
-    /* If any equation does not satisfy the diagonal dominance condition then
-     * re-order */
-    if (abs(a[i][i]) < sum) {
-      tmp = a[i];
-      a[i] = a[indx];
-      a[indx] = tmp;
-      count++; /* This variables counts the number of re-ordered equations */
-    } else {
-      i++;
-    }
-    if (count == n - 1)
-      break;
-  }
-
-  /* Apply the Gauss elimination method */
-  for (i = 0; i < n - 1; i++) {
-    for (j = i + 1; j < n; j++) {
-      r = a[j][i] / a[i][i];
-      for (k = 0; k < n + 1; k++)
-        a[j][k] = a[j][k] - r * a[i][k];
-    }
-  }
-
-  /* Apply back-tracking */
-  x[n - 1] = a[n - 1][n] / a[n - 1][n - 1];
-
-  for (i = n - 2; i >= 0; i--) {
-    x[i] = a[i][n - 1];
-    for (j = i; j < n; j++) {
-      x[i] = x[i] - a[i][j] * x[j];
-    }
-    x[i] = x[i] / a[i][i];
+  if (gauss_elimination_solve(n, a, x) != GAUSS_SUCCESS) {
+    free(x);
+    x = NULL;
   }
+  free(a);
 
   /* Return solution */
   return (x);
@@ -10,8 +10,14 @@
 
 #define gauss_real double
 
+/* Return codes of gauss_elimination_solve */
+#define GAUSS_SUCCESS 0
+#define GAUSS_SINGULAR 1
+
 /* Functions are declared below */
 gauss_real* gauss_elimination(int n, gauss_real** matrix_a,
                               gauss_real* vector_b);
 
+int gauss_elimination_solve(int n, gauss_real* augmented, gauss_real* x);
+
 /* -- End of file -- */
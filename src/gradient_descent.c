@@ -1,4 +1,5 @@
 #include "gradient_descent.h"
+#include <string.h>
 
 /**
  * @brief Transforms an N dimension function into a 1 dimension function from
@@ -416,3 +417,306 @@ int gradient_descent(function func, derivative dfunc, gradient_real* min,
   // We should not reach here something went wrong
   return GRADIENT_ERROR;
 }
+
+/**
+ * @brief Evaluates the function and its gradient at a given step along a
+ * direction
+ *
+ * @param func Function to minimize
+ * @param dfunc Derivative of the function to minimize
+ * @param point Initial point to base the movement of
+ * @param direction Direction in which to move
+ * @param n Number of dimensions of the function
+ * @param step Distance to move by along the direction
+ * @param trial Return parameter containing the point reached
+ * @param trialGradient Return parameter containing the gradient at trial
+ * @param slope Return parameter containing the derivative along the direction
+ * @return Value of the function at trial
+ */
+static gradient_real evaluateStep(function func, derivative dfunc,
+                                  gradient_real point[],
+                                  gradient_real direction[], int n,
+                                  gradient_real step, gradient_real trial[],
+                                  gradient_real trialGradient[],
+                                  gradient_real* slope) {
+  for (int i = 0; i < n; i++) {
+    trial[i] = point[i] + step * direction[i];
+  }
+  dfunc(trial, trialGradient);
+
+  *slope = 0.0;
+  for (int i = 0; i < n; i++) {
+    *slope += trialGradient[i] * direction[i];
+  }
+  return func(trial);
+}
+
+/**
+ * @brief Computes the minimizer of the cubic interpolating the values and the
+ * slopes of two steps, kept away from their ends. Falls back to bisection when
+ * the cubic has no minimum
+ *
+ * @param a First step
+ * @param fa Value at the first step
+ * @param da Slope at the first step
+ * @param b Second step
+ * @param fb Value at the second step
+ * @param db Slope at the second step
+ * @return Step between a and b
+ */
+static gradient_real cubicStep(gradient_real a, gradient_real fa,
+                               gradient_real da, gradient_real b,
+                               gradient_real fb, gradient_real db) {
+  gradient_real d1 = da + db - 3.0 * (fa - fb) / (a - b);
+  gradient_real discriminant = d1 * d1 - da * db;
+  gradient_real low = fmin(a, b);
+  gradient_real width = fabs(b - a);
+  gradient_real step = 0.5 * (a + b);
+
+  if (discriminant >= 0.0) {
+    gradient_real d2 = SIGN(sqrt(discriminant), b - a);
+    gradient_real denominator = db - da + 2.0 * d2;
+    if (fabs(denominator) > EPS) {
+      step = b - (b - a) * (db + d2 - d1) / denominator;
+    }
+  }
+
+  // Stay inside the interval to always reduce it
+  return fmin(fmax(step, low + 0.1 * width), low + 0.9 * width);
+}
+
+/**
+ * @brief Finds a step along a descent direction satisfying the strong Wolfe
+ * conditions. Larger steps are tried until the minimum is bracketed, then the
+ * bracket is reduced with safeguarded cubic interpolation
+ *
+ * @param func Function to minimize
+ * @param dfunc Derivative of the function to minimize
+ * @param point Initial point. Will contain the point reached after the
+ * function executes
+ * @param value Value of the function at point. Will contain the value at the
+ * point reached
+ * @param gradient Gradient at point. Will contain the gradient at the point
+ * reached
+ * @param direction Descent direction in which to move
+ * @param n Number of dimensions of the function
+ * @param step Initial step
+ * @return Value indicating if the line search was a succes or an error
+ */
+static int wolfeLineSearch(function func, derivative dfunc,
+                           gradient_real point[], gradient_real* value,
+                           gradient_real gradient[],
+                           gradient_real direction[], int n,
+                           gradient_real step) {
+  gradient_real trial[n];
+  gradient_real trialGradient[n];
+
+  const gradient_real value0 = *value;
+  gradient_real slope0 = 0.0;
+  for (int i = 0; i < n; i++) {
+    slope0 += gradient[i] * direction[i];
+  }
+  if (slope0 >= 0.0) {
+    return GRADIENT_ERROR;
+  }
+
+  // Best step satisfying the sufficient decrease so far, and the other end of
+  // the bracket once the minimum is bracketed
+  gradient_real low = 0.0, fLow = value0, dLow = slope0;
+  gradient_real high = 0.0, fHigh = value0, dHigh = slope0;
+  int bracketed = 0;
+
+  for (int iter = 0; iter < ITMAX_WOLFE; iter++) {
+    if (bracketed) {
+      step = cubicStep(low, fLow, dLow, high, fHigh, dHigh);
+    }
+
+    gradient_real slope;
+    gradient_real fStep = evaluateStep(func, dfunc, point, direction, n, step,
+                                       trial, trialGradient, &slope);
+
+    if (fStep > value0 + WOLFE_DECREASE * step * slope0 || fStep >= fLow) {
+      // The step is too long: the minimum lies between low and step
+      high = step;
+      fHigh = fStep;
+      dHigh = slope;
+      bracketed = 1;
+      continue;
+    }
+
+    if (fabs(slope) <= -WOLFE_CURVATURE * slope0) {
+      memcpy(point, trial, n * sizeof(gradient_real));
+      memcpy(gradient, trialGradient, n * sizeof(gradient_real));
+      *value = fStep;
+      return GRADIENT_SUCCESS;
+    }
+
+    // The function increases after step: the minimum lies between low and
+    // step
+    if (bracketed ? slope * (high - low) >= 0.0 : slope > 0.0) {
+      high = low;
+      fHigh = fLow;
+      dHigh = dLow;
+      bracketed = 1;
+    }
+    low = step;
+    fLow = fStep;
+    dLow = slope;
+
+    if (!bracketed) {
+      step *= 2.0;
+    }
+  }
+
+  // Fall back on the best step found, which still decreases the function
+  if (low > 0.0) {
+    *value = evaluateStep(func, dfunc, point, direction, n, low, trial,
+                          trialGradient, &dLow);
+    memcpy(point, trial, n * sizeof(gradient_real));
+    memcpy(gradient, trialGradient, n * sizeof(gradient_real));
+    return GRADIENT_SUCCESS;
+  }
+  return GRADIENT_ERROR;
+}
+
+/**
+ * @brief Applies the limited-memory BFGS method to find the minimum of a
+ * provided function. The inverse Hessian is approximated from the last
+ * history steps and gradient changes, and each iteration uses an inexact line
+ * search, which needs far fewer function evaluations than the exact line
+ * search of gradient_descent
+ *
+ * @param func Function to minimize
+ * @param dfunc Derivative of the function to minimize
+ * @param min Return parameter containing the value of the function at the
+ * minimum
+ * @param guess Initial guess from which to start the search. Return parameter
+ * containing the minimum point
+ * @param n Number of dimensions of the function
+ * @param history Number of corrections kept, at least 1 and usually between 3
+ * and 20
+ * @param tol Tolerance for the estimate of the minimum. Should be no smaller
+ * then the square-root of the machine floating point precision
+ * @param iterations Maximum number of iterations before stoping the search.
+ * Return parameter containing the number of iterations done
+ * @return Value indicating if the descent was a succes or an error
+ */
+int lbfgs(function func, derivative dfunc, gradient_real* min,
+          gradient_real guess[], int n, int history, gradient_real tol,
+          int* iterations) {
+  if (history < 1) {
+    return GRADIENT_ERROR;
+  }
+
+  // Steps and gradient changes of the last iterations, used circularly
+  gradient_real steps[history * n];
+  gradient_real changes[history * n];
+  gradient_real rho[history];
+  gradient_real alpha[history];
+
+  gradient_real gradient[n];
+  gradient_real direction[n];
+  int nbCorrections = 0;
+  int newest = history - 1;
+
+  gradient_real value = func(guess);
+  dfunc(guess, gradient);
+
+  for (int its = 0; its < *iterations; its++) {
+    // Two-loop recursion: direction = -H * gradient
+    for (int i = 0; i < n; i++) {
+      direction[i] = -gradient[i];
+    }
+    for (int k = 0; k < nbCorrections; k++) {
+      int slot = (newest - k + history) % history;
+      gradient_real dot = 0.0;
+      for (int i = 0; i < n; i++) {
+        dot += steps[slot * n + i] * direction[i];
+      }
+      alpha[slot] = rho[slot] * dot;
+      for (int i = 0; i < n; i++) {
+        direction[i] -= alpha[slot] * changes[slot * n + i];
+      }
+    }
+
+    // Initial Hessian scaled by the newest curvature
+    gradient_real step = 1.0;
+    if (nbCorrections > 0) {
+      gradient_real yy = 0.0;
+      for (int i = 0; i < n; i++) {
+        yy += changes[newest * n + i] * changes[newest * n + i];
+      }
+      for (int i = 0; i < n; i++) {
+        direction[i] /= rho[newest] * yy;
+      }
+    } else {
+      // Without curvature information, the first step has a unit length
+      gradient_real norm = 0.0;
+      for (int i = 0; i < n; i++) {
+        norm += gradient[i] * gradient[i];
+      }
+      step = 1.0 / (sqrt(norm) + EPS);
+    }
+
+    for (int k = nbCorrections - 1; k >= 0; k--) {
+      int slot = (newest - k + history) % history;
+      gradient_real dot = 0.0;
+      for (int i = 0; i < n; i++) {
+        dot += changes[slot * n + i] * direction[i];
+      }
+      gradient_real beta = rho[slot] * dot;
+      for (int i = 0; i < n; i++) {
+        direction[i] += (alpha[slot] - beta) * steps[slot * n + i];
+      }
+    }
+
+    // The next correction is the difference between the two iterates
+    int next = (newest + 1) % history;
+    for (int i = 0; i < n; i++) {
+      steps[next * n + i] = -guess[i];
+      changes[next * n + i] = -gradient[i];
+    }
+
+    gradient_real previousValue = value;
+    int status = wolfeLineSearch(func, dfunc, guess, &value, gradient,
+                                 direction, n, step);
+    if (status == GRADIENT_ERROR) {
+      return GRADIENT_ERROR;
+    }
+
+    // Checks if we have reached a minimum
+    if (2.0 * fabs(value - previousValue) <=
+        tol * (fabs(value) + fabs(previousValue) + EPS)) {
+      *iterations = its;
+      *min = value;
+      return GRADIENT_SUCCESS;
+    }
+
+    // Keep the correction only if it has a positive curvature, relatively to
+    // the lengths of the step and of the gradient change so that it does not
+    // depend on the scale of the function
+    gradient_real sy = 0.0;
+    gradient_real ss = 0.0;
+    gradient_real yy = 0.0;
+    for (int i = 0; i < n; i++) {
+      steps[next * n + i] += guess[i];
+      changes[next * n + i] += gradient[i];
+      sy += steps[next * n + i] * changes[next * n + i];
+      ss += steps[next * n + i] * steps[next * n + i];
+      yy += changes[next * n + i] * changes[next * n + i];
+    }
+    if (sy > EPS * sqrt(ss * yy)) {
+      rho[next] = 1.0 / sy;
+      newest = next;
+      if (nbCorrections < history) {
+        nbCorrections++;
+      }
+    } else if (nbCorrections == history) {
+      // The oldest correction was overwritten
+      nbCorrections--;
+    }
+  }
+
+  // We should not reach here something went wrong
+  return GRADIENT_ERROR;
+}
@@ -34,6 +34,21 @@ typedef REAL_NUMBER gradient_real;
 #define CGOLD 0.3819660
 #define GOLD 1.618034
 
+// Constants of the sufficient decrease and curvature conditions (strong Wolfe
+// conditions) of the inexact line search of lbfgs
+#ifndef WOLFE_DECREASE
+#define WOLFE_DECREASE 1.0e-4
+#endif
+
+#ifndef WOLFE_CURVATURE
+#define WOLFE_CURVATURE 0.9
+#endif
+
+// Limit the number of trial steps in the inexact line search of lbfgs
+#ifndef ITMAX_WOLFE
+#define ITMAX_WOLFE 30
+#endif
+
 #define GRADIENT_ERROR 1
 #define GRADIENT_SUCCESS 0
 
@@ -58,6 +73,9 @@ extern "C" {
 int gradient_descent(function func, derivative dfunc, gradient_real* min,
                      gradient_real guess[], int n, gradient_real tol,
                      int* iterations);
+int lbfgs(function func, derivative dfunc, gradient_real* min,
+          gradient_real guess[], int n, int history, gradient_real tol,
+          int* iterations);
 
 #ifdef __cplusplus
 }
@@ -84,6 +84,54 @@ void jacobiMatrixMultiply(real_number* firstMatrix, real_number* secondMatrix,
   }
 }
 
+/**
+ * Computes the cosine and sine of the jacobi rotation that cancels the element
+ * apq of the 2x2 symmetric matrix [app apq; apq aqq]
+ * @param app first diagonal element
+ * @param aqq second diagonal element
+ * @param apq off diagonal element to cancel
+ * @param smallestAngle whether to use the rotation of angle at most pi / 4
+ * instead of the one of the classical and cyclic versions
+ * @param c pointer where the cosine of the rotation will be stored
+ * @param s pointer where the sine of the rotation will be stored
+ */
+static void jacobiComputeRotation(real_number app, real_number aqq,
+                                  real_number apq, vec_size smallestAngle,
+                                  real_number* c, real_number* s) {
+
+  // The element is already cancelled, the rotation is the identity
+  if (apq == 0) {
+    *c = 1.0;
+    *s = 0.0;
+    return;
+  }
+
+  real_number tau = (aqq - app) / (2.0 * apq);
+  if (tau == 0 && !smallestAngle) {
+    *c = sqrt(0.5);
+    *s = *c;
+    return;
+  }
+
+  // The tangent t of the angle is the root of largest magnitude of
+  // t^2 + 2 * tau * t - 1 = 0. It is computed as -1 / r, where r is the root
+  // of smallest magnitude, so that c and s do not overflow when tau is large
+  real_number r = 1.0 / (fabs(tau) + hypot(tau, 1.0));
+  if (tau < 0) {
+    r = -r;
+  }
+  real_number norm = sqrt(1 + r * r);
+
+  if (smallestAngle) {
+    *c = 1.0 / norm;
+    *s = r / norm;
+    return;
+  }
+
+  *c = fabs(r) / norm;
+  *s = (r >= 0 ? -1.0 : 1.0) / norm;
+}
+
 /**
  * Creates a jacobi rotation matrix (1 on the diagonal and the value of
  * cos(angle) and sin(angle) at row p and q)
@@ -95,17 +143,10 @@ void jacobiMatrixMultiply(real_number* firstMatrix, real_number* secondMatrix,
 void jacobiCreateRotationMatrix(real_number* input, vec_size row, vec_size col,
                                 real_number* output, vec_size size) {
 
-  real_number aqq = input[coordToIndex(col, col, size)];
-  real_number app = input[coordToIndex(row, row, size)];
-  real_number apq = input[coordToIndex(row, col, size)];
-
-  real_number tau = (aqq - app) / (2.0 * apq);
-  real_number t1 = -tau - sqrt(1 + tau * tau);
-  real_number t2 = -tau + sqrt(1 + tau * tau);
-  real_number t = fabs(t1) > fabs(t2) ? t1 : t2;
-
-  real_number c = 1.0 / (sqrt(1 + t * t));
-  real_number s = c * t;
+  real_number c, s;
+  jacobiComputeRotation(input[coordToIndex(row, row, size)],
+                        input[coordToIndex(col, col, size)],
+                        input[coordToIndex(row, col, size)], 0, &c, &s);
 
   vec_size cIndex1 = coordToIndex(row, row, size);
   vec_size cIndex2 = coordToIndex(col, col, size);
@@ -128,6 +169,52 @@ void jacobiCreateRotationMatrix(real_number* input, vec_size row, vec_size col,
   }
 }
 
+/**
+ * Applies the jacobi rotation that cancels the element at (row, col) in place.
+ * This is equivalent to computing transpose(R) * matrix * R and
+ * eigenVectors * R, where R is the matrix built by jacobiCreateRotationMatrix,
+ * but only the rows and columns row and col are modified so the cost is
+ * O(size) instead of O(size^3)
+ * @param matrix square matrix to rotate
+ * @param eigenVectors matrix of the accumulated rotations (same size as the
+ * matrix)
+ * @param size size of the matrix
+ * @param row row of the element to cancel
+ * @param col column of the element to cancel
+ */
+void jacobiApplyRotation(real_number* matrix, real_number* eigenVectors,
+                         vec_size size, vec_size row, vec_size col) {
+
+  real_number c, s;
+  jacobiComputeRotation(matrix[coordToIndex(row, row, size)],
+                        matrix[coordToIndex(col, col, size)],
+                        matrix[coordToIndex(row, col, size)], 0, &c, &s);
+
+  // matrix * R and eigenVectors * R only change the columns row and col
+  for (vec_size k = 0; k < size; ++k) {
+    real_number* akp = &matrix[coordToIndex(k, row, size)];
+    real_number* akq = &matrix[coordToIndex(k, col, size)];
+    real_number tmp = *akp;
+    *akp = c * tmp - s * *akq;
+    *akq = s * tmp + c * *akq;
+
+    real_number* vkp = &eigenVectors[coordToIndex(k, row, size)];
+    real_number* vkq = &eigenVectors[coordToIndex(k, col, size)];
+    tmp = *vkp;
+    *vkp = c * tmp - s * *vkq;
+    *vkq = s * tmp + c * *vkq;
+  }
+
+  // transpose(R) * matrix only changes the rows row and col
+  real_number* rowP = &matrix[coordToIndex(row, 0, size)];
+  real_number* rowQ = &matrix[coordToIndex(col, 0, size)];
+  for (vec_size k = 0; k < size; ++k) {
+    real_number tmp = rowP[k];
+    rowP[k] = c * tmp - s * rowQ[k];
+    rowQ[k] = s * tmp + c * rowQ[k];
+  }
+}
+
 /**
  * Creates the identity matrix (1 on the diagonal and 0 on other coordinates)
  * @param size size of the matrix
@@ -152,16 +239,137 @@ void jacobiCreateIdentityMatrix(vec_size size, real_number* output) {
  */
 real_number jacobiComputeOffDiagonalSum(real_number* matrix, vec_size size) {
   real_number sum = 0;
-  vec_size sizeSquared = size * size;
 
-  for (vec_size i = 0; i < sizeSquared; ++i) {
-    if (!isDiagonal(i, size)) {
-      sum += fabs(matrix[i]);
+  for (vec_size row = 0; row < size; ++row) {
+    const real_number* currentRow = &matrix[coordToIndex(row, 0, size)];
+    for (vec_size col = 0; col < size; ++col) {
+      if (col != row) {
+        sum += fabs(currentRow[col]);
+      }
     }
   }
   return sum;
 }
 
+/**
+ * Computes the off diagonal absolute sum of the elements in the rows and
+ * columns p and q, which are the only elements modified by a jacobi rotation
+ * @param matrix matrix to compute the sum on
+ * @param size size of matrix
+ * @param p first row and column
+ * @param q second row and column
+ */
+static real_number jacobiRotatedOffDiagonalSum(real_number* matrix,
+                                               vec_size size, vec_size p,
+                                               vec_size q) {
+  real_number sum = 0;
+
+  for (vec_size k = 0; k < size; ++k) {
+    if (k != p) {
+      sum += fabs(matrix[coordToIndex(p, k, size)]);
+    }
+    if (k != q) {
+      sum += fabs(matrix[coordToIndex(q, k, size)]);
+    }
+    // Elements (p, q) and (q, p) are already part of the rows
+    if (k != p && k != q) {
+      sum += fabs(matrix[coordToIndex(k, p, size)]);
+      sum += fabs(matrix[coordToIndex(k, q, size)]);
+    }
+  }
+  return sum;
+}
+
+/**
+ * Finds the column of the off diagonal element with the highest absolute value
+ * in a row
+ * @param matrix square matrix
+ * @param size size of the matrix
+ * @param row row to scan
+ */
+static vec_size jacobiRowMaxIndex(real_number* matrix, vec_size size,
+                                  vec_size row) {
+  const real_number* currentRow = &matrix[coordToIndex(row, 0, size)];
+  vec_size maxCol = row == 0 ? 1 : 0;
+
+  for (vec_size col = maxCol + 1; col < size; ++col) {
+    if (col != row && fabs(currentRow[col]) > fabs(currentRow[maxCol])) {
+      maxCol = col;
+    }
+  }
+  return maxCol;
+}
+
+/**
+ * Updates the cached column of the maximum element of every row after a
+ * jacobi rotation on the rows and columns p and q. Rows p and q are scanned
+ * again, other rows only need to be scanned again when their maximum was in
+ * column p or q and decreased.
+ * @param matrix square matrix after the rotation
+ * @param size size of the matrix
+ * @param rowMaxCol column of the maximum element of each row
+ * @param p first row and column of the rotation
+ * @param q second row and column of the rotation
+ */
+static void jacobiUpdateRowMaxIndices(real_number* matrix, vec_size size,
+                                      vec_size* rowMaxCol, vec_size p,
+                                      vec_size q) {
+  for (vec_size row = 0; row < size; ++row) {
+    if (row == p || row == q) {
+      rowMaxCol[row] = jacobiRowMaxIndex(matrix, size, row);
+      continue;
+    }
+
+    const real_number* currentRow = &matrix[coordToIndex(row, 0, size)];
+    vec_size maxCol = rowMaxCol[row];
+    if (maxCol == p || maxCol == q) {
+      rowMaxCol[row] = jacobiRowMaxIndex(matrix, size, row);
+      continue;
+    }
+
+    real_number maxElement = fabs(currentRow[maxCol]);
+    vec_size first = p < q ? p : q;
+    vec_size second = p < q ? q : p;
+    if (fabs(currentRow[first]) > maxElement ||
+        (fabs(currentRow[first]) == maxElement && first < maxCol)) {
+      maxCol = first;
+      maxElement = fabs(currentRow[first]);
+    }
+    if (fabs(currentRow[second]) > maxElement ||
+        (fabs(currentRow[second]) == maxElement && second < maxCol)) {
+      maxCol = second;
+    }
+    rowMaxCol[row] = maxCol;
+  }
+}
+
+/**
+ * Finds the off diagonal element with the highest absolute value from the
+ * cached maximum of every row in O(size)
+ * @param matrix square matrix
+ * @param size size of the matrix
+ * @param rowMaxCol column of the maximum element of each row
+ * @param maxRow pointer where the row of the maximum element will be stored
+ * @param maxCol pointer where the column of the maximum element will be stored
+ */
+static void jacobiCachedMaxIndex(real_number* matrix, vec_size size,
+                                 vec_size* rowMaxCol, vec_size* maxRow,
+                                 vec_size* maxCol) {
+  vec_size currentMaxRow = 0;
+  real_number maxElement = fabs(matrix[coordToIndex(0, rowMaxCol[0], size)]);
+
+  for (vec_size row = 1; row < size; ++row) {
+    real_number elem = fabs(matrix[coordToIndex(row, rowMaxCol[row], size)]);
+    if (elem > maxElement) {
+      maxElement = elem;
+      currentMaxRow = row;
+    }
+  }
+
+  *maxRow = currentMaxRow;
+  *maxCol = rowMaxCol[currentMaxRow];
+}
+
 /**
  * Computes the jacobi method to find the eigenvalues and eigenvectors of the
  * input matrix
@@ -178,15 +386,21 @@ real_number jacobiComputeOffDiagonalSum(real_number* matrix, vec_size size) {
 void jacobi(real_number* inputMatrix, vec_size size, real_number* outputMatrix,
             vec_size max_iterations, vec_size cyclic) {
 
-  vec_size sizes3d[3] = {size, size, size};
   vec_size sweepSize =
       (size * (size - 1) >>
        1); // A sweep is defined as a n * (n - 1) / 2 jacobi rotations
-  real_number rotationMatrix[size * size];
-  real_number vBuffer[size * size];
-  real_number aBuffer[size * size];
   vec_size maxRow, maxCol, indexToMinimize = 0;
   vec_size sizeSquared = size * size;
+  real_number precision = pow(10, -(DIGITS_PRECISION + 2));
+
+  // Column of the maximum off diagonal element of each row, only used by the
+  // classical version
+  vec_size rowMaxCol[cyclic ? 1 : size];
+  if (!cyclic) {
+    for (vec_size row = 0; row < size; ++row) {
+      rowMaxCol[row] = jacobiRowMaxIndex(inputMatrix, size, row);
+    }
+  }
 
   jacobiCreateIdentityMatrix(size, outputMatrix);
   real_number currentOffDiagonalSum =
@@ -209,7 +423,7 @@ void jacobi(real_number* inputMatrix, vec_size size, real_number* outputMatrix,
       maxCol = indexToMinimize % size;
 
     } else {
-      jacobiMaxIndex(inputMatrix, size, &maxRow, &maxCol);
+      jacobiCachedMaxIndex(inputMatrix, size, rowMaxCol, &maxRow, &maxCol);
     }
 
     if (i < 3 * sweepSize &&
@@ -219,10 +433,9 @@ void jacobi(real_number* inputMatrix, vec_size size, real_number* outputMatrix,
       real_number epsilon_sweep =
           0.20 * (currentOffDiagonalSum) / ((real_number)(sizeSquared));
 
-      if (fabs(inputMatrix[coordToIndex(maxRow, maxCol, size)]) >
+      if (fabs(inputMatrix[coordToIndex(maxRow, maxCol, size)]) <=
           epsilon_sweep) {
-        jacobiCreateRotationMatrix(inputMatrix, maxRow, maxCol, rotationMatrix,
-                                   size);
+        continue;
       }
     } else {
 
@@ -232,21 +445,419 @@ void jacobi(real_number* inputMatrix, vec_size size, real_number* outputMatrix,
 
       // If |apq| << |app| and |apq << |aqq|, set the element to 0 and continue
       // with other element
-      real_number precision = pow(10, -(DIGITS_PRECISION + 2));
       if (apq < precision * app && apq < precision * aqq) {
         inputMatrix[coordToIndex(maxRow, maxCol, size)] = 0;
+        currentOffDiagonalSum -= apq;
+        if (!cyclic) {
+          rowMaxCol[maxRow] = jacobiRowMaxIndex(inputMatrix, size, maxRow);
+        }
         i--;
         continue;
       }
+    }
+
+    // Only the rows and columns maxRow and maxCol are modified by the
+    // rotation, so the off diagonal sum is updated from them
+    real_number rotatedSum =
+        jacobiRotatedOffDiagonalSum(inputMatrix, size, maxRow, maxCol);
+    jacobiApplyRotation(inputMatrix, outputMatrix, size, maxRow, maxCol);
+    if (!cyclic) {
+      jacobiUpdateRowMaxIndices(inputMatrix, size, rowMaxCol, maxRow, maxCol);
+    }
+
+    if ((i + 1) % sweepSize == 0) {
+      // Recompute the whole sum once per sweep to discard rounding errors
+      currentOffDiagonalSum = jacobiComputeOffDiagonalSum(inputMatrix, size);
+    } else {
+      currentOffDiagonalSum +=
+          jacobiRotatedOffDiagonalSum(inputMatrix, size, maxRow, maxCol) -
+          rotatedSum;
+    }
+  }
+}
+
+/**
+ * Computes the jacobi method to find the eigenvalues and eigenvectors of the
+ * input matrix using the parallel ordering of Brent and Luk. Each step applies
+ * size / 2 rotations on disjoint pairs of rows and columns, so they can be
+ * applied at the same time. Pairs are generated by a round robin tournament
+ * so that every pair is rotated once per sweep of size - 1 steps. Rotations
+ * of angle at most pi / 4 are used, which is required for this ordering to
+ * converge, so the eigenvalues may not be in the same order as with jacobi.
+ * When compiled with OpenMP, the rotations of a step are spread over the
+ * threads of a single parallel region.
+ * @param inputMatrix matrix whose eigenvalues and eigenvectors we are looking
+ * for (will contain the eigenvalues after this function has been called)
+ * @param size size of the matrix (matrix must be square)
+ * @param outputMatrix matrix containing every eigenvector of the input matrix
+ * (same size as the input matrix)
+ * @param max_sweeps max number of sweeps the algorithm can do (set to -1 to
+ * allow any amount of sweeps)
+ */
+void jacobiParallel(real_number* inputMatrix, vec_size size,
+                    real_number* outputMatrix, vec_size max_sweeps) {
+
+  // An odd size is padded with a dummy index that is never rotated
+  const vec_size players = size + (size & 1);
+  const vec_size nbPairs = players >> 1;
+  vec_size top[nbPairs];
+  vec_size bottom[nbPairs];
+  real_number cosines[nbPairs];
+  real_number sines[nbPairs];
+  real_number precision = pow(10, -(DIGITS_PRECISION + 2));
+
+  jacobiCreateIdentityMatrix(size, outputMatrix);
+  real_number currentOffDiagonalSum =
+      jacobiComputeOffDiagonalSum(inputMatrix, size);
+  vec_size allowInfiniteSweeps = max_sweeps == -1;
+
+  // A single parallel region for every sweep: the angles, the tournament and
+  // the convergence test are computed by one thread, the rotations by all
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+  for (vec_size sweep = 0; (allowInfiniteSweeps || sweep < max_sweeps) &&
+                           currentOffDiagonalSum > EPSILON;
+       ++sweep) {
+
+    for (vec_size step = 0; step + 1 < players; ++step) {
+
+#ifdef _OPENMP
+#pragma omp single
+#endif
+      {
+        if (step == 0) {
+          for (vec_size k = 0; k < nbPairs; ++k) {
+            top[k] = 2 * k;
+            bottom[k] = 2 * k + 1;
+          }
+        } else {
+          // Move to the next round of the tournament. The first player stays
+          // in place while the others rotate around it
+          vec_size lastTop = top[nbPairs - 1];
+          for (vec_size k = nbPairs - 1; k > 1; --k) {
+            top[k] = top[k - 1];
+          }
+          if (nbPairs > 1) {
+            top[1] = bottom[0];
+          }
+          for (vec_size k = 0; k + 1 < nbPairs; ++k) {
+            bottom[k] = bottom[k + 1];
+          }
+          bottom[nbPairs - 1] = lastTop;
+        }
+
+        // The angles of every pair only depend on the matrix before the step
+        for (vec_size k = 0; k < nbPairs; ++k) {
+          vec_size p = top[k];
+          vec_size q = bottom[k];
+          cosines[k] = 1.0;
+          sines[k] = 0.0;
+          if (p >= size || q >= size) {
+            continue;
+          }
+
+          real_number apq = inputMatrix[coordToIndex(p, q, size)];
+          real_number app = inputMatrix[coordToIndex(p, p, size)];
+          real_number aqq = inputMatrix[coordToIndex(q, q, size)];
+          if (fabs(apq) < precision * fabs(app) &&
+              fabs(apq) < precision * fabs(aqq)) {
+            inputMatrix[coordToIndex(p, q, size)] = 0;
+            inputMatrix[coordToIndex(q, p, size)] = 0;
+            continue;
+          }
+          jacobiComputeRotation(app, aqq, apq, 1, &cosines[k], &sines[k]);
+        }
+      }
+
+      // matrix * R and eigenVectors * R, every pair modifies its own columns
+#ifdef _OPENMP
+#pragma omp for
+#endif
+      for (vec_size k = 0; k < nbPairs; ++k) {
+        vec_size p = top[k];
+        vec_size q = bottom[k];
+        real_number c = cosines[k];
+        real_number s = sines[k];
+        if (s == 0.0) {
+          continue;
+        }
+        for (vec_size row = 0; row < size; ++row) {
+          real_number* akp = &inputMatrix[coordToIndex(row, p, size)];
+          real_number* akq = &inputMatrix[coordToIndex(row, q, size)];
+          real_number tmp = *akp;
+          *akp = c * tmp - s * *akq;
+          *akq = s * tmp + c * *akq;
 
-      jacobiCreateRotationMatrix(inputMatrix, maxRow, maxCol, rotationMatrix,
-                                 size);
+          real_number* vkp = &outputMatrix[coordToIndex(row, p, size)];
+          real_number* vkq = &outputMatrix[coordToIndex(row, q, size)];
+          tmp = *vkp;
+          *vkp = c * tmp - s * *vkq;
+          *vkq = s * tmp + c * *vkq;
+        }
+      }
+
+      // transpose(R) * matrix, every pair modifies its own rows
+#ifdef _OPENMP
+#pragma omp for
+#endif
+      for (vec_size k = 0; k < nbPairs; ++k) {
+        real_number c = cosines[k];
+        real_number s = sines[k];
+        if (s == 0.0) {
+          continue;
+        }
+        real_number* rowP = &inputMatrix[coordToIndex(top[k], 0, size)];
+        real_number* rowQ = &inputMatrix[coordToIndex(bottom[k], 0, size)];
+        for (vec_size col = 0; col < size; ++col) {
+          real_number tmp = rowP[col];
+          rowP[col] = c * tmp - s * rowQ[col];
+          rowQ[col] = s * tmp + c * rowQ[col];
+        }
+      }
     }
 
-    jacobiMatrixMultiply(rotationMatrix, inputMatrix, sizes3d, aBuffer, 1);
-    jacobiMatrixMultiply(aBuffer, rotationMatrix, sizes3d, inputMatrix, 0);
-    jacobiMatrixMultiply(outputMatrix, rotationMatrix, sizes3d, vBuffer, 0);
-    memcpy(outputMatrix, vBuffer, sizeof(real_number) * sizeSquared);
+    // Every thread tests the convergence after the barrier of single
+#ifdef _OPENMP
+#pragma omp single
+#endif
     currentOffDiagonalSum = jacobiComputeOffDiagonalSum(inputMatrix, size);
   }
 }
+
+/**
+ * Computes the singular value decomposition of a matrix with the one-sided
+ * jacobi method of Hestenes. Pairs of columns are rotated until they are all
+ * orthogonal, which is equivalent to applying the jacobi method on
+ * transpose(A) * A without ever forming it. A pair of columns is rotated
+ * while their dot product is larger than rows * 10^-DIGITS_PRECISION times
+ * the product of their norms, so that the convergence does not depend on the
+ * scale of the matrix. The sweeps stop when no pair was rotated.
+ * @param inputMatrix rows x cols matrix to decompose. Will contain U * S
+ * (unsorted) after this function has been called
+ * @param rows number of rows of the matrix
+ * @param cols number of columns of the matrix
+ * @param nbSingular number of singular values to keep (at most cols)
+ * @param singularValues array containing the nbSingular largest singular
+ * values in decreasing order
+ * @param uMatrix rows x nbSingular matrix containing the left singular vectors
+ * as columns. Can be NULL
+ * @param vMatrix cols x cols matrix in which the rotations are accumulated.
+ * Its first nbSingular columns contain the right singular vectors after this
+ * function has been called. Can be NULL
+ * @param max_sweeps max number of sweeps the algorithm can do (set to -1 to
+ * allow any amount of sweeps)
+ */
+void jacobiSVD(real_number* inputMatrix, vec_size rows, vec_size cols,
+               vec_size nbSingular, real_number* singularValues,
+               real_number* uMatrix, real_number* vMatrix,
+               vec_size max_sweeps) {
+
+  // Rounding errors on the dot products grow with the number of rows
+  real_number precision = rows * pow(10, -DIGITS_PRECISION);
+  real_number norms[cols];
+  vec_size order[cols];
+
+  if (vMatrix != NULL) {
+    jacobiCreateIdentityMatrix(cols, vMatrix);
+  }
+
+  vec_size rotated = 1;
+  vec_size allowInfiniteSweeps = max_sweeps == -1;
+  for (vec_size sweep = 0;
+       (allowInfiniteSweeps || sweep < max_sweeps) && rotated; ++sweep) {
+
+    rotated = 0;
+    for (vec_size p = 0; p < cols; ++p) {
+      for (vec_size q = p + 1; q < cols; ++q) {
+        // Elements (p, p), (q, q) and (p, q) of transpose(A) * A
+        real_number app = 0, aqq = 0, apq = 0;
+        for (vec_size row = 0; row < rows; ++row) {
+          real_number x = inputMatrix[coordToIndex(row, p, cols)];
+          real_number y = inputMatrix[coordToIndex(row, q, cols)];
+          app += x * x;
+          aqq += y * y;
+          apq += x * y;
+        }
+
+        // The columns are orthogonal relatively to their norms
+        if (fabs(apq) <= precision * sqrt(app) * sqrt(aqq)) {
+          continue;
+        }
+
+        real_number c, s;
+        jacobiComputeRotation(app, aqq, apq, 1, &c, &s);
+        if (s == 0.0) {
+          continue;
+        }
+        rotated = 1;
+
+        for (vec_size row = 0; row < rows; ++row) {
+          real_number* x = &inputMatrix[coordToIndex(row, p, cols)];
+          real_number* y = &inputMatrix[coordToIndex(row, q, cols)];
+          real_number tmp = *x;
+          *x = c * tmp - s * *y;
+          *y = s * tmp + c * *y;
+        }
+        if (vMatrix == NULL) {
+          continue;
+        }
+        for (vec_size row = 0; row < cols; ++row) {
+          real_number* x = &vMatrix[coordToIndex(row, p, cols)];
+          real_number* y = &vMatrix[coordToIndex(row, q, cols)];
+          real_number tmp = *x;
+          *x = c * tmp - s * *y;
+          *y = s * tmp + c * *y;
+        }
+      }
+    }
+  }
+
+  // The singular values are the norms of the columns
+  for (vec_size col = 0; col < cols; ++col) {
+    real_number sum = 0;
+    for (vec_size row = 0; row < rows; ++row) {
+      real_number elem = inputMatrix[coordToIndex(row, col, cols)];
+      sum += elem * elem;
+    }
+    norms[col] = sqrt(sum);
+    order[col] = col;
+  }
+
+  // Only the nbSingular largest singular values need to be sorted
+  for (vec_size i = 0; i < nbSingular; ++i) {
+    vec_size maxIndex = i;
+    for (vec_size j = i + 1; j < cols; ++j) {
+      if (norms[order[j]] > norms[order[maxIndex]]) {
+        maxIndex = j;
+      }
+    }
+    vec_size tmp = order[i];
+    order[i] = order[maxIndex];
+    order[maxIndex] = tmp;
+  }
+
+  for (vec_size i = 0; i < nbSingular; ++i) {
+    vec_size col = order[i];
+    real_number sigma = norms[col];
+    singularValues[i] = sigma;
+
+    if (uMatrix != NULL) {
+      for (vec_size row = 0; row < rows; ++row) {
+        uMatrix[coordToIndex(row, i, nbSingular)] =
+            sigma > 0 ? inputMatrix[coordToIndex(row, col, cols)] / sigma : 0;
+      }
+    }
+  }
+
+  // Move the right singular vectors in the order of the singular values
+  if (vMatrix != NULL) {
+    real_number sortedRow[nbSingular];
+    for (vec_size row = 0; row < cols; ++row) {
+      real_number* vRow = &vMatrix[coordToIndex(row, 0, cols)];
+      for (vec_size i = 0; i < nbSingular; ++i) {
+        sortedRow[i] = vRow[order[i]];
+      }
+      memcpy(vRow, sortedRow, nbSingular * sizeof(real_number));
+    }
+  }
+}
+
+/**
+ * Converts a 2d coordinate in a symmetric matrix to an index in its packed
+ * upper triangular storage
+ */
+static inline vec_size packedIndex(vec_size row, vec_size col, vec_size size) {
+  if (row > col) {
+    vec_size tmp = row;
+    row = col;
+    col = tmp;
+  }
+  return row * size - ((row * (row - 1)) >> 1) + col - row;
+}
+
+/**
+ * Computes the cyclic jacobi method on a symmetric matrix stored in packed
+ * upper triangular form (row by row, size * (size + 1) / 2 elements). Only the
+ * packed matrix is needed when the eigenvectors are not requested. The sweeps
+ * stop when the off diagonal sum is below 10^-DIGITS_PRECISION times the sum
+ * of the absolute values of the diagonal, whatever the scale of the matrix.
+ * @param packedMatrix upper triangle of the symmetric matrix whose
+ * eigenvalues we are looking for (will be diagonal after this function has
+ * been called)
+ * @param size size of the matrix
+ * @param eigenValues array containing the size eigenvalues
+ * @param eigenVectors matrix containing every eigenvector as columns (size *
+ * size elements). Can be NULL when only the eigenvalues are needed
+ * @param max_sweeps max number of sweeps the algorithm can do (set to -1 to
+ * allow any amount of sweeps)
+ */
+void jacobiPacked(real_number* packedMatrix, vec_size size,
+                  real_number* eigenValues, real_number* eigenVectors,
+                  vec_size max_sweeps) {
+
+  real_number precision = pow(10, -DIGITS_PRECISION);
+  if (eigenVectors != NULL) {
+    jacobiCreateIdentityMatrix(size, eigenVectors);
+  }
+
+  real_number currentOffDiagonalSum = 1;
+  real_number diagonalSum = 0;
+  vec_size allowInfiniteSweeps = max_sweeps == -1;
+  for (vec_size sweep = 0; (allowInfiniteSweeps || sweep < max_sweeps) &&
+                           currentOffDiagonalSum > precision * diagonalSum;
+       ++sweep) {
+
+    currentOffDiagonalSum = 0;
+    diagonalSum = 0;
+    for (vec_size p = 0; p < size; ++p) {
+      diagonalSum += fabs(packedMatrix[packedIndex(p, p, size)]);
+    }
+    for (vec_size p = 0; p < size; ++p) {
+      for (vec_size q = p + 1; q < size; ++q) {
+        vec_size pqIndex = packedIndex(p, q, size);
+        real_number apq = packedMatrix[pqIndex];
+        currentOffDiagonalSum += 2 * fabs(apq);
+
+        real_number app = packedMatrix[packedIndex(p, p, size)];
+        real_number aqq = packedMatrix[packedIndex(q, q, size)];
+        real_number c, s;
+        jacobiComputeRotation(app, aqq, apq, 1, &c, &s);
+        if (s == 0.0) {
+          continue;
+        }
+
+        // Only one of the elements (k, p) and (p, k) is stored
+        for (vec_size k = 0; k < size; ++k) {
+          if (k == p || k == q) {
+            continue;
+          }
+          real_number* akp = &packedMatrix[packedIndex(k, p, size)];
+          real_number* akq = &packedMatrix[packedIndex(k, q, size)];
+          real_number tmp = *akp;
+          *akp = c * tmp - s * *akq;
+          *akq = s * tmp + c * *akq;
+        }
+        packedMatrix[packedIndex(p, p, size)] =
+            c * c * app - 2 * c * s * apq + s * s * aqq;
+        packedMatrix[packedIndex(q, q, size)] =
+            s * s * app + 2 * c * s * apq + c * c * aqq;
+        packedMatrix[pqIndex] = 0;
+
+        if (eigenVectors != NULL) {
+          for (vec_size k = 0; k < size; ++k) {
+            real_number* vkp = &eigenVectors[coordToIndex(k, p, size)];
+            real_number* vkq = &eigenVectors[coordToIndex(k, q, size)];
+            real_number tmp = *vkp;
+            *vkp = c * tmp - s * *vkq;
+            *vkq = s * tmp + c * *vkq;
+          }
+        }
+      }
+    }
+  }
+
+  for (vec_size i = 0; i < size; ++i) {
+    eigenValues[i] = packedMatrix[packedIndex(i, i, size)];
+  }
+}
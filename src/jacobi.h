@@ -35,8 +35,19 @@ void jacobiMatrixMultiply(real_number* firstMatrix, real_number* secondMatrix,
                           vec_size transposeFirstMatrix);
 void jacobiCreateRotationMatrix(real_number* input, vec_size row, vec_size col,
                                 real_number* output, vec_size size);
+void jacobiApplyRotation(real_number* matrix, real_number* eigenVectors,
+                         vec_size size, vec_size row, vec_size col);
 void jacobi(real_number* inputMatrix, vec_size size, real_number* outputMatrix,
             vec_size iterations, vec_size cyclic);
+void jacobiParallel(real_number* inputMatrix, vec_size size,
+                    real_number* outputMatrix, vec_size max_sweeps);
+void jacobiSVD(real_number* inputMatrix, vec_size rows, vec_size cols,
+               vec_size nbSingular, real_number* singularValues,
+               real_number* uMatrix, real_number* vMatrix,
+               vec_size max_sweeps);
+void jacobiPacked(real_number* packedMatrix, vec_size size,
+                  real_number* eigenValues, real_number* eigenVectors,
+                  vec_size max_sweeps);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,481 @@
+#include "krylov.h"
+#include "matrix.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief Computes the dot product of two vectors
+ */
+static krylov_real dot(const krylov_real* first, const krylov_real* second,
+                       const int n) {
+  krylov_real sum = 0;
+  for (int i = 0; i < n; ++i) {
+    sum += first[i] * second[i];
+  }
+  return sum;
+}
+
+/**
+ * @brief Applies the preconditioner, or copies the input if there is none
+ */
+static void precondition(krylov_matvec preconditioner, void* data,
+                         const krylov_real* input, krylov_real* output,
+                         const int n) {
+  if (preconditioner) {
+    preconditioner(input, output, data);
+  } else {
+    memcpy(output, input, n * sizeof(krylov_real));
+  }
+}
+
+/**
+ * @brief Computes residual = b - A * x
+ */
+static void computeResidual(krylov_matvec matrix, void* matrixData,
+                            const krylov_real* b, const krylov_real* x,
+                            krylov_real* residual, const int n) {
+  matrix(x, residual, matrixData);
+  for (int i = 0; i < n; ++i) {
+    residual[i] = b[i] - residual[i];
+  }
+}
+
+/**
+ * @brief Computes output = A * input for a CSR matrix
+ *
+ * @param input Vector of nbRows elements
+ * @param output Vector of nbRows elements
+ * @param data Pointer to the CSRMatrix
+ */
+void CSRMatrixVector(const krylov_real* input, krylov_real* output,
+                     void* data) {
+  const CSRMatrix* matrix = (const CSRMatrix*)data;
+  for (int i = 0; i < matrix->nbRows; ++i) {
+    krylov_real sum = 0;
+    for (int k = matrix->rowStart[i]; k < matrix->rowStart[i + 1]; ++k) {
+      sum += matrix->values[k] * input[matrix->columns[k]];
+    }
+    output[i] = sum;
+  }
+}
+
+/**
+ * @brief Computes the inverse of the diagonal of a CSR matrix
+ *
+ * @param matrix The matrix to precondition
+ * @param preconditioner The preconditioner. Its inverseDiagonal member must
+ * point to an array of nbRows elements
+ * @return KRYLOV_SUCCESS or KRYLOV_BREAKDOWN if a diagonal element is null
+ */
+int jacobiPreconditionerInit(const CSRMatrix* matrix,
+                             JacobiPreconditioner* preconditioner) {
+  preconditioner->size = matrix->nbRows;
+  for (int i = 0; i < matrix->nbRows; ++i) {
+    krylov_real diagonal = 0;
+    for (int k = matrix->rowStart[i]; k < matrix->rowStart[i + 1]; ++k) {
+      if (matrix->columns[k] == i) {
+        diagonal = matrix->values[k];
+      }
+    }
+    if (diagonal == 0) {
+      return KRYLOV_BREAKDOWN;
+    }
+    preconditioner->inverseDiagonal[i] = 1 / diagonal;
+  }
+  return KRYLOV_SUCCESS;
+}
+
+/**
+ * @brief Computes output = diag(A)^-1 * input
+ *
+ * @param input Vector of size elements
+ * @param output Vector of size elements
+ * @param data Pointer to the JacobiPreconditioner
+ */
+void jacobiPreconditionerApply(const krylov_real* input, krylov_real* output,
+                               void* data) {
+  const JacobiPreconditioner* preconditioner =
+      (const JacobiPreconditioner*)data;
+  for (int i = 0; i < preconditioner->size; ++i) {
+    output[i] = preconditioner->inverseDiagonal[i] * input[i];
+  }
+}
+
+/**
+ * @brief Computes the incomplete LU factorization without fill-in of a CSR
+ * matrix whose rows all contain their diagonal element
+ *
+ * @param matrix The matrix to precondition
+ * @param preconditioner The preconditioner. Its values member must point to
+ * an array of rowStart[nbRows] elements and its diagonal member to an array
+ * of nbRows elements
+ * @return KRYLOV_SUCCESS or KRYLOV_BREAKDOWN if a diagonal element is missing
+ * or a null pivot is found
+ */
+int ILU0PreconditionerInit(const CSRMatrix* matrix,
+                           ILU0Preconditioner* preconditioner) {
+  const int* rowStart = matrix->rowStart;
+  const int* columns = matrix->columns;
+  krylov_real* values = preconditioner->values;
+  int* diagonal = preconditioner->diagonal;
+
+  preconditioner->matrix = matrix;
+  memcpy(values, matrix->values,
+         rowStart[matrix->nbRows] * sizeof(krylov_real));
+
+  for (int i = 0; i < matrix->nbRows; ++i) {
+    diagonal[i] = -1;
+    for (int k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+      if (columns[k] == i) {
+        diagonal[i] = k;
+      }
+    }
+    if (diagonal[i] < 0) {
+      return KRYLOV_BREAKDOWN;
+    }
+  }
+
+  for (int i = 0; i < matrix->nbRows; ++i) {
+    // Eliminate the elements of row i on the left of the diagonal
+    for (int k = rowStart[i]; k < diagonal[i]; ++k) {
+      const int pivotRow = columns[k];
+      values[k] /= values[diagonal[pivotRow]];
+
+      // Both rows are sorted, so the common columns are found by merging them
+      int other = diagonal[pivotRow] + 1;
+      for (int j = k + 1; j < rowStart[i + 1]; ++j) {
+        while (other < rowStart[pivotRow + 1] && columns[other] < columns[j]) {
+          ++other;
+        }
+        if (other == rowStart[pivotRow + 1]) {
+          break;
+        }
+        if (columns[other] == columns[j]) {
+          values[j] -= values[k] * values[other];
+        }
+      }
+    }
+    if (values[diagonal[i]] == 0) {
+      return KRYLOV_BREAKDOWN;
+    }
+  }
+
+  return KRYLOV_SUCCESS;
+}
+
+/**
+ * @brief Computes output = (L * U)^-1 * input with forward and backward
+ * substitutions
+ *
+ * @param input Vector of nbRows elements
+ * @param output Vector of nbRows elements
+ * @param data Pointer to the ILU0Preconditioner
+ */
+void ILU0PreconditionerApply(const krylov_real* input, krylov_real* output,
+                             void* data) {
+  const ILU0Preconditioner* preconditioner = (const ILU0Preconditioner*)data;
+  const int* rowStart = preconditioner->matrix->rowStart;
+  const int* columns = preconditioner->matrix->columns;
+  const krylov_real* values = preconditioner->values;
+  const int* diagonal = preconditioner->diagonal;
+  const int n = preconditioner->matrix->nbRows;
+
+  for (int i = 0; i < n; ++i) {
+    krylov_real sum = input[i];
+    for (int k = rowStart[i]; k < diagonal[i]; ++k) {
+      sum -= values[k] * output[columns[k]];
+    }
+    output[i] = sum;
+  }
+  for (int i = n - 1; i >= 0; --i) {
+    krylov_real sum = output[i];
+    for (int k = diagonal[i] + 1; k < rowStart[i + 1]; ++k) {
+      sum -= values[k] * output[columns[k]];
+    }
+    output[i] = sum / values[diagonal[i]];
+  }
+}
+
+/**
+ * @brief Solves A * x = b with the preconditioned conjugate gradient method.
+ * A and the preconditioner must be symmetric positive definite
+ *
+ * @param matrix Callback computing A * input
+ * @param matrixData Data forwarded to matrix
+ * @param preconditioner Callback computing M^-1 * input. Can be NULL
+ * @param preconditionerData Data forwarded to preconditioner
+ * @param b The right-hand side
+ * @param x The initial guess. Will contain the solution
+ * @param n Size of the system
+ * @param tol Tolerance on ||b - A * x|| / ||b||
+ * @param iterations Maximum number of iterations. Will contain the number of
+ * iterations done
+ * @param work Buffer of KRYLOV_CG_WORK_SIZE(n) elements
+ * @return KRYLOV_SUCCESS, KRYLOV_NOT_CONVERGED or KRYLOV_BREAKDOWN
+ */
+int conjugateGradient(krylov_matvec matrix, void* matrixData,
+                      krylov_matvec preconditioner, void* preconditionerData,
+                      const krylov_real* b, krylov_real* x, const int n,
+                      const krylov_real tol, int* iterations,
+                      krylov_real* work) {
+  krylov_real* r = work;
+  krylov_real* z = &work[n];
+  krylov_real* p = &work[2 * n];
+  krylov_real* q = &work[3 * n];
+  const int maxIterations = *iterations;
+  krylov_real bNorm = sqrt(dot(b, b, n));
+  if (bNorm == 0) {
+    bNorm = 1;
+  }
+
+  computeResidual(matrix, matrixData, b, x, r, n);
+  precondition(preconditioner, preconditionerData, r, z, n);
+  memcpy(p, z, n * sizeof(krylov_real));
+  krylov_real rz = dot(r, z, n);
+
+  for (*iterations = 0; *iterations < maxIterations; ++*iterations) {
+    if (sqrt(dot(r, r, n)) <= tol * bNorm) {
+      return KRYLOV_SUCCESS;
+    }
+
+    matrix(p, q, matrixData);
+    krylov_real pq = dot(p, q, n);
+    if (pq == 0) {
+      return KRYLOV_BREAKDOWN;
+    }
+    krylov_real alpha = rz / pq;
+    for (int i = 0; i < n; ++i) {
+      x[i] += alpha * p[i];
+      r[i] -= alpha * q[i];
+    }
+
+    precondition(preconditioner, preconditionerData, r, z, n);
+    krylov_real rzNew = dot(r, z, n);
+    krylov_real beta = rzNew / rz;
+    rz = rzNew;
+    for (int i = 0; i < n; ++i) {
+      p[i] = z[i] + beta * p[i];
+    }
+  }
+
+  return sqrt(dot(r, r, n)) <= tol * bNorm ? KRYLOV_SUCCESS
+                                            : KRYLOV_NOT_CONVERGED;
+}
+
+/**
+ * @brief Solves A * x = b with the right preconditioned BiCGSTAB method, for
+ * general non symmetric matrices
+ *
+ * @param matrix Callback computing A * input
+ * @param matrixData Data forwarded to matrix
+ * @param preconditioner Callback computing M^-1 * input. Can be NULL
+ * @param preconditionerData Data forwarded to preconditioner
+ * @param b The right-hand side
+ * @param x The initial guess. Will contain the solution
+ * @param n Size of the system
+ * @param tol Tolerance on ||b - A * x|| / ||b||
+ * @param iterations Maximum number of iterations. Will contain the number of
+ * iterations done
+ * @param work Buffer of KRYLOV_BICGSTAB_WORK_SIZE(n) elements
+ * @return KRYLOV_SUCCESS, KRYLOV_NOT_CONVERGED or KRYLOV_BREAKDOWN
+ */
+int biCGSTAB(krylov_matvec matrix, void* matrixData,
+             krylov_matvec preconditioner, void* preconditionerData,
+             const krylov_real* b, krylov_real* x, const int n,
+             const krylov_real tol, int* iterations, krylov_real* work) {
+  krylov_real* r = work;
+  krylov_real* rHat = &work[n];
+  krylov_real* p = &work[2 * n];
+  krylov_real* v = &work[3 * n];
+  krylov_real* pHat = &work[4 * n];
+  krylov_real* sHat = &work[5 * n];
+  krylov_real* t = &work[6 * n];
+  const int maxIterations = *iterations;
+  krylov_real bNorm = sqrt(dot(b, b, n));
+  if (bNorm == 0) {
+    bNorm = 1;
+  }
+
+  computeResidual(matrix, matrixData, b, x, r, n);
+  memcpy(rHat, r, n * sizeof(krylov_real));
+  memset(p, 0, n * sizeof(krylov_real));
+  memset(v, 0, n * sizeof(krylov_real));
+  krylov_real rho = 1;
+  krylov_real alpha = 1;
+  krylov_real omega = 1;
+
+  for (*iterations = 0; *iterations < maxIterations; ++*iterations) {
+    if (sqrt(dot(r, r, n)) <= tol * bNorm) {
+      return KRYLOV_SUCCESS;
+    }
+
+    krylov_real rhoNew = dot(rHat, r, n);
+    if (rhoNew == 0) {
+      return KRYLOV_BREAKDOWN;
+    }
+    krylov_real beta = (rhoNew / rho) * (alpha / omega);
+    rho = rhoNew;
+    for (int i = 0; i < n; ++i) {
+      p[i] = r[i] + beta * (p[i] - omega * v[i]);
+    }
+
+    precondition(preconditioner, preconditionerData, p, pHat, n);
+    matrix(pHat, v, matrixData);
+    krylov_real rHatV = dot(rHat, v, n);
+    if (rHatV == 0) {
+      return KRYLOV_BREAKDOWN;
+    }
+    alpha = rho / rHatV;
+
+    // r now holds s = r - alpha * v
+    for (int i = 0; i < n; ++i) {
+      x[i] += alpha * pHat[i];
+      r[i] -= alpha * v[i];
+    }
+    if (sqrt(dot(r, r, n)) <= tol * bNorm) {
+      ++*iterations;
+      return KRYLOV_SUCCESS;
+    }
+
+    precondition(preconditioner, preconditionerData, r, sHat, n);
+    matrix(sHat, t, matrixData);
+    krylov_real tt = dot(t, t, n);
+    omega = tt == 0 ? 0 : dot(t, r, n) / tt;
+    if (omega == 0) {
+      return KRYLOV_BREAKDOWN;
+    }
+    for (int i = 0; i < n; ++i) {
+      x[i] += omega * sHat[i];
+      r[i] -= omega * t[i];
+    }
+  }
+
+  return sqrt(dot(r, r, n)) <= tol * bNorm ? KRYLOV_SUCCESS
+                                            : KRYLOV_NOT_CONVERGED;
+}
+
+/**
+ * @brief Solves A * x = b with the right preconditioned GMRES method
+ * restarted every restart iterations, for general non symmetric matrices.
+ * Only the restart + 1 basis vectors are kept in memory
+ *
+ * @param matrix Callback computing A * input
+ * @param matrixData Data forwarded to matrix
+ * @param preconditioner Callback computing M^-1 * input. Can be NULL
+ * @param preconditionerData Data forwarded to preconditioner
+ * @param b The right-hand side
+ * @param x The initial guess. Will contain the solution
+ * @param n Size of the system
+ * @param restart Size of the Krylov basis before restarting
+ * @param tol Tolerance on ||b - A * x|| / ||b||
+ * @param iterations Maximum number of iterations. Will contain the number of
+ * iterations done
+ * @param work Buffer of KRYLOV_GMRES_WORK_SIZE(n, restart) elements
+ * @return KRYLOV_SUCCESS, KRYLOV_NOT_CONVERGED or KRYLOV_BREAKDOWN if the
+ * Krylov space stops growing, with x improved as far as possible
+ */
+int GMRES(krylov_matvec matrix, void* matrixData, krylov_matvec preconditioner,
+          void* preconditionerData, const krylov_real* b, krylov_real* x,
+          const int n, const int restart, const krylov_real tol,
+          int* iterations, krylov_real* work) {
+  // Basis vectors V are stored one after the other, followed by z
+  krylov_real* z = &work[(restart + 1) * n];
+  krylov_real hessenberg[(restart + 1) * restart];
+  krylov_real cosines[restart];
+  krylov_real sines[restart];
+  krylov_real g[restart + 1];
+  const int maxIterations = *iterations;
+  krylov_real bNorm = sqrt(dot(b, b, n));
+  if (bNorm == 0) {
+    bNorm = 1;
+  }
+
+  *iterations = 0;
+  while (1) {
+    krylov_real* v0 = work;
+    computeResidual(matrix, matrixData, b, x, v0, n);
+    krylov_real beta = computeNorm(v0, n);
+    if (beta <= tol * bNorm) {
+      return KRYLOV_SUCCESS;
+    }
+    if (*iterations >= maxIterations) {
+      return KRYLOV_NOT_CONVERGED;
+    }
+    vectorScale(v0, n, 1 / beta);
+    memset(g, 0, (restart + 1) * sizeof(krylov_real));
+    g[0] = beta;
+
+    int size = 0;
+    int breakdown = 0;
+    while (size < restart && *iterations < maxIterations) {
+      const int j = size;
+      krylov_real* w = &work[(j + 1) * n];
+      precondition(preconditioner, preconditionerData, &work[j * n], z, n);
+      matrix(z, w, matrixData);
+
+      // Modified Gram-Schmidt against the previous basis vectors
+      for (int i = 0; i <= j; ++i) {
+        krylov_real h = dot(w, &work[i * n], n);
+        hessenberg[coordToIndex(i, j, restart)] = h;
+        for (int k = 0; k < n; ++k) {
+          w[k] -= h * work[i * n + k];
+        }
+      }
+      krylov_real wNorm = computeNorm(w, n);
+      hessenberg[coordToIndex(j + 1, j, restart)] = wNorm;
+
+      // Reduce the new column of the Hessenberg matrix with Givens rotations
+      for (int i = 0; i < j; ++i) {
+        krylov_real* first = &hessenberg[coordToIndex(i, j, restart)];
+        krylov_real* second = &hessenberg[coordToIndex(i + 1, j, restart)];
+        krylov_real tmp = cosines[i] * *first + sines[i] * *second;
+        *second = -sines[i] * *first + cosines[i] * *second;
+        *first = tmp;
+      }
+      krylov_real* diagonal = &hessenberg[coordToIndex(j, j, restart)];
+      krylov_real radius = hypot(*diagonal, wNorm);
+      if (radius == 0) {
+        // The new column is null: keep the correction of the previous ones
+        breakdown = 1;
+        break;
+      }
+      cosines[j] = *diagonal / radius;
+      sines[j] = wNorm / radius;
+      *diagonal = radius;
+      hessenberg[coordToIndex(j + 1, j, restart)] = 0;
+      g[j + 1] = -sines[j] * g[j];
+      g[j] = cosines[j] * g[j];
+
+      ++size;
+      ++*iterations;
+      if (fabs(g[j + 1]) <= tol * bNorm || wNorm == 0) {
+        break;
+      }
+      vectorScale(w, n, 1 / wNorm);
+    }
+
+    // Solve H * y = g in place in g and accumulate z = V * y
+    for (int i = size - 1; i >= 0; --i) {
+      for (int k = i + 1; k < size; ++k) {
+        g[i] -= hessenberg[coordToIndex(i, k, restart)] * g[k];
+      }
+      g[i] /= hessenberg[coordToIndex(i, i, restart)];
+    }
+    memset(z, 0, n * sizeof(krylov_real));
+    for (int i = 0; i < size; ++i) {
+      for (int k = 0; k < n; ++k) {
+        z[k] += g[i] * work[i * n + k];
+      }
+    }
+
+    // x += M^-1 * z, using the basis vector following the last one as buffer
+    krylov_real* correction = &work[size * n];
+    precondition(preconditioner, preconditionerData, z, correction, n);
+    for (int k = 0; k < n; ++k) {
+      x[k] += correction[k];
+    }
+    if (breakdown) {
+      return KRYLOV_BREAKDOWN;
+    }
+  }
+}
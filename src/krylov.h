@@ -0,0 +1,88 @@
+#ifndef KRYLOV_H
+#define KRYLOV_H
+
+typedef double krylov_real;
+
+#define KRYLOV_SUCCESS 0
+#define KRYLOV_NOT_CONVERGED 1
+#define KRYLOV_BREAKDOWN 2
+
+// Size of the work buffer needed by each solver for a system of size n
+#define KRYLOV_CG_WORK_SIZE(n) (4 * (n))
+#define KRYLOV_BICGSTAB_WORK_SIZE(n) (7 * (n))
+#define KRYLOV_GMRES_WORK_SIZE(n, restart) (((restart) + 2) * (n))
+
+/**
+ * Computes output = A * input for the linear operator A, or output = M^-1 *
+ * input for a preconditioner M. data is forwarded untouched from the solver
+ * call, it can hold the matrix or any state the callback needs
+ */
+typedef void (*krylov_matvec)(const krylov_real* input, krylov_real* output,
+                              void* data);
+
+/**
+ * Sparse matrix in compressed sparse row format. The columns of row i are
+ * columns[rowStart[i]] to columns[rowStart[i + 1] - 1], sorted in increasing
+ * order, and values holds the matching elements
+ */
+typedef struct {
+  int nbRows;
+  const int* rowStart;
+  const int* columns;
+  const krylov_real* values;
+} CSRMatrix;
+
+/**
+ * Jacobi preconditioner M = diag(A)
+ */
+typedef struct {
+  int size;
+  krylov_real* inverseDiagonal;
+} JacobiPreconditioner;
+
+/**
+ * Incomplete LU factorization without fill-in. L and U share the sparsity
+ * pattern of the matrix, L has an implicit unit diagonal
+ */
+typedef struct {
+  const CSRMatrix* matrix;
+  krylov_real* values;
+  int* diagonal;
+} ILU0Preconditioner;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void CSRMatrixVector(const krylov_real* input, krylov_real* output,
+                     void* data);
+
+int jacobiPreconditionerInit(const CSRMatrix* matrix,
+                             JacobiPreconditioner* preconditioner);
+void jacobiPreconditionerApply(const krylov_real* input, krylov_real* output,
+                               void* data);
+
+int ILU0PreconditionerInit(const CSRMatrix* matrix,
+                           ILU0Preconditioner* preconditioner);
+void ILU0PreconditionerApply(const krylov_real* input, krylov_real* output,
+                             void* data);
+
+int conjugateGradient(krylov_matvec matrix, void* matrixData,
+                      krylov_matvec preconditioner, void* preconditionerData,
+                      const krylov_real* b, krylov_real* x, const int n,
+                      const krylov_real tol, int* iterations,
+                      krylov_real* work);
+int biCGSTAB(krylov_matvec matrix, void* matrixData,
+             krylov_matvec preconditioner, void* preconditionerData,
+             const krylov_real* b, krylov_real* x, const int n,
+             const krylov_real tol, int* iterations, krylov_real* work);
+int GMRES(krylov_matvec matrix, void* matrixData, krylov_matvec preconditioner,
+          void* preconditionerData, const krylov_real* b, krylov_real* x,
+          const int n, const int restart, const krylov_real tol,
+          int* iterations, krylov_real* work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
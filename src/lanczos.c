@@ -1,10 +1,35 @@
 #include "lanczos.h"
+#include "jacobi.h"
 #include "linear_congruential_random_generator.h"
 #include "matrix.h"
+#include <float.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Limit the number of sweeps used to diagonalize the small matrix T
+#ifndef LANCZOS_MAX_SWEEPS
+#define LANCZOS_MAX_SWEEPS 50
+#endif
+
+/**
+ * Removes from vectorToChange its projection on every vector of vectorList.
+ * Vectors in vectorList are assumed to be orthonormal.
+ */
+static void orthogonalize(lanczos_real* vectorList, uint_least8_t nbVectors,
+                          uint_least8_t vectorLength,
+                          lanczos_real* vectorToChange) {
+  unsigned int dims[] = {1, vectorLength, 1};
+  for (uint_least8_t i = 0; i < nbVectors; ++i) {
+    const lanczos_real* vector = &vectorList[i * vectorLength];
+    lanczos_real dotProduct;
+    matrixMultiply(vector, vectorToChange, dims, &dotProduct, 0);
+    for (uint_least8_t k = 0; k < vectorLength; ++k) {
+      vectorToChange[k] -= dotProduct * vector[k];
+    }
+  }
+}
+
 /**
  * Assume all vectors in vectorList
  * are already orthonormal and unit vectors
@@ -20,17 +45,7 @@
 static void gramSchmidt(lanczos_real* vectorList, uint_least8_t nbVectors,
                         uint_least8_t vectorLength,
                         lanczos_real* vectorToChange) {
-  for (uint_least8_t i = 0; i < nbVectors; ++i) {
-    lanczos_real dotProduct;
-    unsigned int dims[] = {1, vectorLength, 1};
-    lanczos_real tmpVector[vectorLength];
-
-    memcpy(tmpVector, &vectorList[i * vectorLength],
-           vectorLength * sizeof(lanczos_real));
-    matrixMultiply(tmpVector, vectorToChange, dims, &dotProduct, 0);
-    vectorScale(tmpVector, vectorLength, dotProduct);
-    vectorSubstract(vectorToChange, tmpVector, vectorLength);
-  }
+  orthogonalize(vectorList, nbVectors, vectorLength, vectorToChange);
   lanczos_real norm = computeNorm(vectorToChange, vectorLength);
   vectorScale(vectorToChange, vectorLength, 1.0 / norm);
 }
@@ -43,9 +58,58 @@ static void getRandomUnitVector(lanczos_real* vector, uint_least8_t dim) {
   makeUnitVector(vector, dim);
 }
 
+/**
+ * Updates the estimates omegaNext[k] of the dot products between the new
+ * Lanczos vector q(i+1) and every previous vector q(k) using the
+ * omega-recurrence of Simon. omega and omegaPrevious contain the estimates for
+ * q(i) and q(i-1). Returns the largest estimate in absolute value.
+ */
+static lanczos_real updateOmega(const lanczos_real* alphas,
+                                const lanczos_real* betas, uint_least8_t i,
+                                uint_least8_t dim,
+                                const lanczos_real* omegaPrevious,
+                                const lanczos_real* omega,
+                                lanczos_real* omegaNext) {
+  const lanczos_real psi = DBL_EPSILON * sqrt((lanczos_real)dim);
+  lanczos_real maxOmega = 0;
+
+  for (uint_least8_t k = 0; k < i; ++k) {
+    lanczos_real value =
+        betas[k] * omega[k + 1] + (alphas[k] - alphas[i]) * omega[k];
+    if (k > 0) {
+      value += betas[k - 1] * omega[k - 1];
+    }
+    if (i > 0) {
+      value -= betas[i - 1] * omegaPrevious[k];
+    }
+    // Account for the rounding errors made at this iteration
+    value += (value >= 0 ? 1 : -1) * DBL_EPSILON * (betas[k] + betas[i]);
+    omegaNext[k] = value / betas[i];
+
+    if (fabs(omegaNext[k]) > maxOmega) {
+      maxOmega = fabs(omegaNext[k]);
+    }
+  }
+  omegaNext[i] = psi;
+  omegaNext[i + 1] = 1;
+
+  return maxOmega;
+}
+
 void lanczos(lanczos_real* matrix, uint_least8_t dim, uint_least8_t nbIter,
              lanczos_real* initialVector, lanczos_real* tMatrix,
              lanczos_real* vMatrix) {
+  lanczosWithReorthogonalization(matrix, dim, nbIter, initialVector, tMatrix,
+                                 vMatrix, FullReorthogonalization, NULL);
+}
+
+void lanczosWithReorthogonalization(lanczos_real* matrix, uint_least8_t dim,
+                                    uint_least8_t nbIter,
+                                    lanczos_real* initialVector,
+                                    lanczos_real* tMatrix,
+                                    lanczos_real* vMatrix,
+                                    reorthogonalizationType type,
+                                    uint_least8_t* nbReorthogonalizations) {
   lanczos_real q0[dim];
   lanczos_real q1[dim];
 
@@ -53,6 +117,16 @@ void lanczos(lanczos_real* matrix, uint_least8_t dim, uint_least8_t nbIter,
   // Temporary vector to store the transpose of the V matrix.
   lanczos_real vTranspose[nbIter][dim];
 
+  // Values needed by the omega-recurrence in partial reorthogonalization
+  lanczos_real alphas[nbIter];
+  lanczos_real betas[nbIter];
+  lanczos_real omegaPrevious[nbIter + 1];
+  lanczos_real omega[nbIter + 1];
+  lanczos_real omegaNext[nbIter + 1];
+  uint_least8_t reorthogonalizeNext = 0;
+  uint_least8_t reorthogonalizations = 0;
+  omega[0] = 1;
+
   if (initialVector == NULL) {
     // q1 is a random unit vector and q0 is a vector filled with 0
     getRandomUnitVector(q1, dim);
@@ -110,8 +184,37 @@ void lanczos(lanczos_real* matrix, uint_least8_t dim, uint_least8_t nbIter,
       vectorScale(q1, dim, 1.0 / beta);
     }
 
-    // Reorthogonalize the vector q1 using the modified Gram-Schmidth algorithm
-    gramSchmidt(vTranspose[0], i + 1, dim, q1);
+    alphas[i] = alpha;
+    betas[i] = beta;
+
+    if (type == FullReorthogonalization) {
+      // Reorthogonalize the vector q1 using the modified Gram-Schmidth
+      // algorithm
+      gramSchmidt(vTranspose[0], i + 1, dim, q1);
+      ++reorthogonalizations;
+    } else if (i + 1 < nbIter) {
+      // Only reorthogonalize when the estimated loss of orthogonality exceeds
+      // the square root of the machine precision. As proposed by Simon, the
+      // following vector is also reorthogonalized.
+      uint_least8_t breakdown = beta <= 0.00001;
+      lanczos_real maxOmega = 1;
+      if (!breakdown) {
+        maxOmega = updateOmega(alphas, betas, i, dim, omegaPrevious, omega,
+                               omegaNext);
+      }
+      if (breakdown || reorthogonalizeNext || maxOmega > sqrt(DBL_EPSILON)) {
+        gramSchmidt(vTranspose[0], i + 1, dim, q1);
+        ++reorthogonalizations;
+        for (uint_least8_t k = 0; k <= i; ++k) {
+          omegaNext[k] = DBL_EPSILON * sqrt((lanczos_real)dim);
+        }
+        omegaNext[i + 1] = 1;
+        reorthogonalizeNext = !reorthogonalizeNext && !breakdown;
+      }
+
+      memcpy(omegaPrevious, omega, (i + 1) * sizeof(lanczos_real));
+      memcpy(omega, omegaNext, (i + 2) * sizeof(lanczos_real));
+    }
 
     // Fill the matrix T with the current alpha and beta values
     tMatrix[i * nbIter + i] = alpha;
@@ -123,4 +226,298 @@ void lanczos(lanczos_real* matrix, uint_least8_t dim, uint_least8_t nbIter,
 
   matrix_size vMatrixSize[] = {nbIter, dim};
   matrixTranspose(vTranspose[0], vMatrix, vMatrixSize);
+  if (nbReorthogonalizations != NULL) {
+    *nbReorthogonalizations = reorthogonalizations;
+  }
+}
+
+/**
+ * Computes every eigen value and eigen vector of a small symmetric matrix
+ * with jacobiPacked on a packed copy of its upper triangle. Eigen values are
+ * sorted in decreasing order and eigenVectors contains the associated eigen
+ * vectors as columns.
+ */
+static void symmetricEigen(const lanczos_real* matrix, uint_least8_t size,
+                           lanczos_real* eigenValues,
+                           lanczos_real* eigenVectors) {
+  lanczos_real packed[size * (size + 1) / 2];
+  unsigned int index = 0;
+  for (uint_least8_t p = 0; p < size; ++p) {
+    for (uint_least8_t q = p; q < size; ++q) {
+      packed[index++] = matrix[p * size + q];
+    }
+  }
+  jacobiPacked(packed, size, eigenValues, eigenVectors, LANCZOS_MAX_SWEEPS);
+
+  // Selection sort of the eigen pairs in decreasing order
+  for (uint_least8_t i = 0; i < size; ++i) {
+    uint_least8_t maxIndex = i;
+    for (uint_least8_t j = i + 1; j < size; ++j) {
+      if (eigenValues[j] > eigenValues[maxIndex]) {
+        maxIndex = j;
+      }
+    }
+    if (maxIndex != i) {
+      lanczos_real tmp = eigenValues[i];
+      eigenValues[i] = eigenValues[maxIndex];
+      eigenValues[maxIndex] = tmp;
+      for (uint_least8_t k = 0; k < size; ++k) {
+        tmp = eigenVectors[k * size + i];
+        eigenVectors[k * size + i] = eigenVectors[k * size + maxIndex];
+        eigenVectors[k * size + maxIndex] = tmp;
+      }
+    }
+  }
+}
+
+/**
+ * Thick-restart Lanczos algorithm. The Krylov basis never grows beyond
+ * krylovSize vectors: once it is full, the Ritz vectors associated with the
+ * largest Ritz values are kept and the basis is extended again from them.
+ * The residual norm of a Ritz pair is given by the last component of its
+ * eigen vector in the space of T times the last beta, so no extra matrix
+ * vector product is needed to test the convergence.
+ */
+int lanczosTopEigen(lanczos_real* matrix, uint_least8_t dim,
+                    uint_least8_t nbEigen, uint_least8_t krylovSize,
+                    lanczos_real* initialVector, lanczos_real tol,
+                    int* restarts, lanczos_real* eigenValues,
+                    lanczos_real* eigenVectors) {
+  if (nbEigen == 0 || krylovSize <= nbEigen || krylovSize > dim) {
+    return LANCZOS_NOT_CONVERGED;
+  }
+
+  const uint_least8_t m = krylovSize;
+  lanczos_real basis[m + 1][dim];
+  lanczos_real tMatrix[m][m];
+  lanczos_real ritzVectors[m][m];
+  lanczos_real ritzValues[m];
+  lanczos_real w[dim];
+  unsigned int matVecDims[3] = {dim, dim, 1};
+  unsigned int dotDims[3] = {1, dim, 1};
+
+  if (initialVector == NULL) {
+    getRandomUnitVector(basis[0], dim);
+  } else {
+    memcpy(basis[0], initialVector, dim * sizeof(lanczos_real));
+    makeUnitVector(basis[0], dim);
+  }
+  memset(tMatrix, 0, sizeof(tMatrix));
+
+  const int maxRestarts = *restarts;
+  int status = LANCZOS_NOT_CONVERGED;
+  uint_least8_t nbKept = 0;
+  lanczos_real lastBeta = 0;
+  int restart;
+  for (restart = 0;; ++restart) {
+    // Extend the basis up to m vectors
+    for (uint_least8_t j = nbKept; j < m; ++j) {
+      matrixMultiply(matrix, basis[j], matVecDims, w, 0);
+
+      lanczos_real alpha;
+      matrixMultiply(basis[j], w, dotDims, &alpha, 0);
+      tMatrix[j][j] = alpha;
+
+      // The first vector after a restart is coupled to every kept Ritz
+      // vector, otherwise this is the usual three terms recurrence
+      uint_least8_t first = (j == nbKept) ? 0 : j - 1;
+      for (uint_least8_t i = first; i < j; ++i) {
+        for (uint_least8_t k = 0; k < dim; ++k) {
+          w[k] -= tMatrix[i][j] * basis[i][k];
+        }
+      }
+      for (uint_least8_t k = 0; k < dim; ++k) {
+        w[k] -= alpha * basis[j][k];
+      }
+      orthogonalize(basis[0], j + 1, dim, w);
+
+      lanczos_real beta = computeNorm(w, dim);
+      if (beta <= 0.00001) {
+        // The basis spans an invariant subspace, continue with a random
+        // vector orthogonal to it
+        beta = 0;
+        getRandomUnitVector(basis[j + 1], dim);
+        gramSchmidt(basis[0], j + 1, dim, basis[j + 1]);
+      } else {
+        memcpy(basis[j + 1], w, dim * sizeof(lanczos_real));
+        vectorScale(basis[j + 1], dim, 1.0 / beta);
+      }
+
+      if (j + 1 < m) {
+        tMatrix[j][j + 1] = beta;
+        tMatrix[j + 1][j] = beta;
+      }
+      lastBeta = beta;
+    }
+
+    symmetricEigen(tMatrix[0], m, ritzValues, ritzVectors[0]);
+
+    status = LANCZOS_SUCCESS;
+    for (uint_least8_t i = 0; i < nbEigen; ++i) {
+      if (fabs(lastBeta * ritzVectors[m - 1][i]) > tol) {
+        status = LANCZOS_NOT_CONVERGED;
+        break;
+      }
+    }
+    if (status == LANCZOS_SUCCESS || restart == maxRestarts) {
+      break;
+    }
+
+    // Keep the Ritz vectors of the largest Ritz values along with the last
+    // basis vector. Each row of the basis is transformed in place.
+    nbKept = nbEigen + (m - nbEigen) / 2;
+    for (uint_least8_t k = 0; k < dim; ++k) {
+      lanczos_real row[nbKept];
+      for (uint_least8_t i = 0; i < nbKept; ++i) {
+        row[i] = 0;
+        for (uint_least8_t j = 0; j < m; ++j) {
+          row[i] += basis[j][k] * ritzVectors[j][i];
+        }
+      }
+      for (uint_least8_t i = 0; i < nbKept; ++i) {
+        basis[i][k] = row[i];
+      }
+    }
+    memcpy(basis[nbKept], basis[m], dim * sizeof(lanczos_real));
+
+    memset(tMatrix, 0, sizeof(tMatrix));
+    for (uint_least8_t i = 0; i < nbKept; ++i) {
+      lanczos_real coupling = lastBeta * ritzVectors[m - 1][i];
+      tMatrix[i][i] = ritzValues[i];
+      tMatrix[i][nbKept] = coupling;
+      tMatrix[nbKept][i] = coupling;
+    }
+  }
+
+  // Transform the Ritz vectors from the space of T to the space of the matrix
+  for (uint_least8_t k = 0; k < dim; ++k) {
+    for (uint_least8_t i = 0; i < nbEigen; ++i) {
+      lanczos_real sum = 0;
+      for (uint_least8_t j = 0; j < m; ++j) {
+        sum += basis[j][k] * ritzVectors[j][i];
+      }
+      eigenVectors[k * nbEigen + i] = sum;
+    }
+  }
+  memcpy(eigenValues, ritzValues, nbEigen * sizeof(lanczos_real));
+
+  *restarts = restart;
+  return status;
+}
+
+/**
+ * Block version of the Lanczos algorithm. Each step multiplies the matrix by
+ * a block of blockSize orthonormal vectors, so the dominant cost is a single
+ * matrix-matrix product per step instead of blockSize matrix-vector products.
+ * Starting from several vectors also allows to find eigen values of
+ * multiplicity up to blockSize.
+ */
+void blockLanczos(lanczos_real* matrix, uint_least8_t dim,
+                  uint_least8_t blockSize, uint_least8_t nbBlocks,
+                  lanczos_real* initialBlock, lanczos_real* tMatrix,
+                  lanczos_real* vMatrix) {
+  const uint_least8_t b = blockSize;
+  const unsigned int size = b * nbBlocks;
+  // Every Lanczos vector is stored as a row, so the vectors of a block are
+  // contiguous
+  lanczos_real vTranspose[size][dim];
+  // Transpose of the product between the matrix and the current block
+  lanczos_real wTranspose[b][dim];
+  lanczos_real aBlock[b][b];
+  lanczos_real bBlock[b][b];
+  unsigned int productDims[3] = {b, dim, dim};
+  unsigned int dotDims[3] = {1, dim, 1};
+
+  for (uint_least8_t p = 0; p < b; ++p) {
+    if (initialBlock == NULL) {
+      getRandomUnitVector(vTranspose[p], dim);
+    } else {
+      for (uint_least8_t k = 0; k < dim; ++k) {
+        vTranspose[p][k] = initialBlock[k * b + p];
+      }
+    }
+    gramSchmidt(vTranspose[0], p, dim, vTranspose[p]);
+  }
+
+  memset(tMatrix, 0, size * size * sizeof(lanczos_real));
+  memset(bBlock, 0, sizeof(bBlock));
+
+  for (uint_least8_t j = 0; j < nbBlocks; ++j) {
+    lanczos_real* block = vTranspose[j * b];
+
+    // transpose(W) = transpose(Q) * A, since A is symmetric
+    matrixMultiply(block, matrix, productDims, wTranspose[0], 0);
+
+    // A(j) = transpose(Q) * W
+    for (uint_least8_t p = 0; p < b; ++p) {
+      for (uint_least8_t q = 0; q < b; ++q) {
+        matrixMultiply(&block[p * dim], wTranspose[q], dotDims, &aBlock[p][q],
+                       0);
+      }
+    }
+
+    // W = W - Q(j) * A(j) - Q(j-1) * transpose(B(j-1))
+    for (uint_least8_t q = 0; q < b; ++q) {
+      for (uint_least8_t p = 0; p < b; ++p) {
+        for (uint_least8_t k = 0; k < dim; ++k) {
+          wTranspose[q][k] -= aBlock[p][q] * block[p * dim + k];
+        }
+        if (j > 0) {
+          const lanczos_real* previous = vTranspose[(j - 1) * b];
+          for (uint_least8_t k = 0; k < dim; ++k) {
+            wTranspose[q][k] -= bBlock[q][p] * previous[p * dim + k];
+          }
+        }
+      }
+      orthogonalize(vTranspose[0], (j + 1) * b, dim, wTranspose[q]);
+    }
+
+    // Fill the diagonal block of T
+    for (uint_least8_t p = 0; p < b; ++p) {
+      for (uint_least8_t q = 0; q < b; ++q) {
+        tMatrix[(j * b + p) * size + j * b + q] = aBlock[p][q];
+      }
+    }
+
+    if (j == nbBlocks - 1) {
+      break;
+    }
+
+    // QR decomposition W = Q(j+1) * B(j) using the modified Gram-Schmidt
+    // algorithm on the columns of W
+    lanczos_real* next = vTranspose[(j + 1) * b];
+    memset(bBlock, 0, sizeof(bBlock));
+    for (uint_least8_t q = 0; q < b; ++q) {
+      for (uint_least8_t p = 0; p < q; ++p) {
+        matrixMultiply(&next[p * dim], wTranspose[q], dotDims, &bBlock[p][q],
+                       0);
+        for (uint_least8_t k = 0; k < dim; ++k) {
+          wTranspose[q][k] -= bBlock[p][q] * next[p * dim + k];
+        }
+      }
+
+      lanczos_real norm = computeNorm(wTranspose[q], dim);
+      if (norm <= 0.00001) {
+        // Special case where the column is linearly dependant. The new vector
+        // is a random vector orthogonal to all previous vectors
+        getRandomUnitVector(&next[q * dim], dim);
+        gramSchmidt(vTranspose[0], (j + 1) * b + q, dim, &next[q * dim]);
+      } else {
+        bBlock[q][q] = norm;
+        memcpy(&next[q * dim], wTranspose[q], dim * sizeof(lanczos_real));
+        vectorScale(&next[q * dim], dim, 1.0 / norm);
+      }
+    }
+
+    // Fill the off diagonal blocks of T with B(j) and transpose(B(j))
+    for (uint_least8_t p = 0; p < b; ++p) {
+      for (uint_least8_t q = 0; q < b; ++q) {
+        tMatrix[((j + 1) * b + p) * size + j * b + q] = bBlock[p][q];
+        tMatrix[(j * b + q) * size + (j + 1) * b + p] = bBlock[p][q];
+      }
+    }
+  }
+
+  matrix_size vMatrixSize[] = {size, dim};
+  matrixTranspose(vTranspose[0], vMatrix, vMatrixSize);
 }
@@ -1,7 +1,18 @@
+#ifndef LANCZOS_H
+#define LANCZOS_H
+
 #include <stdint.h>
 
 typedef double lanczos_real;
 
+#define LANCZOS_SUCCESS 0
+#define LANCZOS_NOT_CONVERGED 1
+
+typedef enum {
+  FullReorthogonalization,
+  PartialReorthogonalization
+} reorthogonalizationType;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -22,6 +33,70 @@ extern "C" {
 void lanczos(lanczos_real* matrix, uint_least8_t dim, uint_least8_t nbIter,
              lanczos_real* initialVector, lanczos_real* tMatrix,
              lanczos_real* vMatrix);
+
+/**
+ * Same as lanczos, but lets the caller choose how the orthogonality of the
+ * Lanczos vectors is maintained.
+ * @input type is FullReorthogonalization to reorthogonalize every new vector
+ * against all the previous ones, or PartialReorthogonalization to only do so
+ * when the omega-recurrence estimates that the orthogonality dropped below the
+ * square root of the machine precision
+ * @output nbReorthogonalizations is the number of Lanczos vectors that were
+ * reorthogonalized. This parameter can be NULL
+ */
+void lanczosWithReorthogonalization(lanczos_real* matrix, uint_least8_t dim,
+                                    uint_least8_t nbIter,
+                                    lanczos_real* initialVector,
+                                    lanczos_real* tMatrix,
+                                    lanczos_real* vMatrix,
+                                    reorthogonalizationType type,
+                                    uint_least8_t* nbReorthogonalizations);
+
+/**
+ * @input matrix is the symmetric matrix for which you want to calculate the
+ * eigen values and eigen vectors
+ * @input dim is the size of the matrix
+ * @input blockSize is the number of vectors advanced at each iteration
+ * @input nbBlocks is the number of iterations of the algorithm
+ * @input initialBlock is a dim x blockSize matrix whose columns are used for
+ * the first iteration of the algorithm. This parameter can be NULL
+ * @output tMatrix is the block tridiagonal matrix T of size
+ * (blockSize * nbBlocks) x (blockSize * nbBlocks)
+ * @output vMatrix is the dim x (blockSize * nbBlocks) matrix V which can be
+ * used to transform eigen vectors from space of T to space of matrix
+ */
+void blockLanczos(lanczos_real* matrix, uint_least8_t dim,
+                  uint_least8_t blockSize, uint_least8_t nbBlocks,
+                  lanczos_real* initialBlock, lanczos_real* tMatrix,
+                  lanczos_real* vMatrix);
+
+/**
+ * @input matrix is the symmetric matrix for which we want the largest eigen
+ * values and eigen vectors
+ * @input dim is the size of the matrix
+ * @input nbEigen is the number of eigen pairs to compute
+ * @input krylovSize is the maximum size of the Krylov basis kept in memory. It
+ * must be greater than nbEigen and at most dim
+ * @input initialVector is a vector used for the first iteration of the
+ * algorithm. This parameter can be NULL
+ * @input tol is the tolerance on the residual norm of each eigen pair
+ * @input/output restarts is the maximum number of restarts. It contains the
+ * number of restarts done after the call
+ * @output eigenValues contains the nbEigen largest eigen values in decreasing
+ * order
+ * @output eigenVectors is a dim x nbEigen matrix where each column is the unit
+ * eigen vector associated with the eigen value of the same index
+ * @return LANCZOS_SUCCESS if every eigen pair converged, LANCZOS_NOT_CONVERGED
+ * otherwise
+ */
+int lanczosTopEigen(lanczos_real* matrix, uint_least8_t dim,
+                    uint_least8_t nbEigen, uint_least8_t krylovSize,
+                    lanczos_real* initialVector, lanczos_real tol,
+                    int* restarts, lanczos_real* eigenValues,
+                    lanczos_real* eigenVectors);
+
 #ifdef __cplusplus
 }
 #endif
+
+#endif
@@ -1,6 +1,8 @@
 #include "lu_decomposition.h"
 #include "matrix.h"
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 /**
@@ -47,3 +49,286 @@ void LUDecomposition(const lu_real* initialMatrix, lu_real* lMatrix,
     }
   }
 }
+
+/**
+ * @brief Perform the blocked LU decomposition with partial pivoting of a
+ * matrix in place. After the call, the strictly lower part of the matrix
+ * contains L (whose diagonal is made of 1) and the upper part contains U, so
+ * that P * A = L * U. The factorization can then be reused by LUSolve and
+ * LUSolveMany for any number of right-hand sides.
+ * When compiled with OpenMP, the row updates of the panel, the block row of U
+ * and the trailing matrix update are spread over the threads of a single
+ * parallel region for matrices larger than LU_PARALLEL_MIN_SIZE.
+ *
+ * @param matrix The matrix to decompose. Will contain L and U
+ * @param pivots Output array of size elements. Row i was swapped with row
+ * pivots[i] at step i
+ * @param size Size of the matrix
+ * @return LU_SUCCESS or LU_SINGULAR if the matrix is singular
+ */
+#define LU_KERNEL_TYPE lu_real
+#define LU_KERNEL_ABS fabs
+#define LU_KERNEL_SWAP swapRows
+#define LU_KERNEL_FACTORIZE LUFactorize
+#include "lu_factorize_kernel.h"
+
+/**
+ * @brief Solve the system A * X = B for a range of columns of B
+ *
+ * @param luMatrix The L and U matrices computed by LUFactorize
+ * @param pivots The pivots computed by LUFactorize
+ * @param size Size of the matrix
+ * @param matrix The size x nbColumns matrix B. Will contain X
+ * @param firstCol First column to solve
+ * @param lastCol Column after the last column to solve
+ * @param nbColumns Number of right-hand sides
+ */
+static void solveColumns(const lu_real* luMatrix, const int* pivots,
+                         const int size, lu_real* matrix, const int firstCol,
+                         const int lastCol, const int nbColumns) {
+  // Apply the permutation P * B
+  for (int i = 0; i < size; ++i) {
+    if (pivots[i] != i) {
+      swapRows(matrix, i, pivots[i], firstCol, lastCol, nbColumns);
+    }
+  }
+
+  // Forward substitution L * Y = P * B
+  for (int i = 1; i < size; ++i) {
+    lu_real* row = &matrix[coordToIndex(i, 0, nbColumns)];
+    for (int k = 0; k < i; ++k) {
+      lu_real factor = luMatrix[coordToIndex(i, k, size)];
+      const lu_real* solved = &matrix[coordToIndex(k, 0, nbColumns)];
+      for (int j = firstCol; j < lastCol; ++j) {
+        row[j] -= factor * solved[j];
+      }
+    }
+  }
+
+  // Backward substitution U * X = Y
+  for (int i = size - 1; i >= 0; --i) {
+    lu_real* row = &matrix[coordToIndex(i, 0, nbColumns)];
+    for (int k = i + 1; k < size; ++k) {
+      lu_real factor = luMatrix[coordToIndex(i, k, size)];
+      const lu_real* solved = &matrix[coordToIndex(k, 0, nbColumns)];
+      for (int j = firstCol; j < lastCol; ++j) {
+        row[j] -= factor * solved[j];
+      }
+    }
+    lu_real diagonal = luMatrix[coordToIndex(i, i, size)];
+    for (int j = firstCol; j < lastCol; ++j) {
+      row[j] /= diagonal;
+    }
+  }
+}
+
+/**
+ * @brief Solve the system A * X = B from the factorization of A computed by
+ * LUFactorize. When compiled with OpenMP, groups of LU_BLOCK_SIZE columns of
+ * B are solved by different threads.
+ *
+ * @param luMatrix The L and U matrices computed by LUFactorize
+ * @param pivots The pivots computed by LUFactorize
+ * @param size Size of the matrix
+ * @param matrix The size x nbColumns matrix B. Will contain X
+ * @param nbColumns Number of right-hand sides
+ */
+void LUSolveMany(const lu_real* luMatrix, const int* pivots, const int size,
+                 lu_real* matrix, const int nbColumns) {
+#ifdef _OPENMP
+#pragma omp parallel for if (size > LU_PARALLEL_MIN_SIZE &&                    \
+                                 nbColumns > LU_BLOCK_SIZE)
+#endif
+  for (int colStart = 0; colStart < nbColumns; colStart += LU_BLOCK_SIZE) {
+    const int colEnd = colStart + LU_BLOCK_SIZE < nbColumns
+                           ? colStart + LU_BLOCK_SIZE
+                           : nbColumns;
+    solveColumns(luMatrix, pivots, size, matrix, colStart, colEnd, nbColumns);
+  }
+}
+
+/**
+ * @brief Solve the system A * x = b from the factorization of A computed by
+ * LUFactorize
+ *
+ * @param luMatrix The L and U matrices computed by LUFactorize
+ * @param pivots The pivots computed by LUFactorize
+ * @param size Size of the matrix
+ * @param vector The vector b. Will contain x
+ */
+void LUSolve(const lu_real* luMatrix, const int* pivots, const int size,
+             lu_real* vector) {
+  solveColumns(luMatrix, pivots, size, vector, 0, 1, 1);
+}
+
+/**
+ * @brief Perform the LU decomposition with partial pivoting of a single
+ * precision matrix in place, with the same blocked algorithm and storage as
+ * LUFactorize
+ *
+ * @param matrix The matrix to decompose. Will contain L and U
+ * @param pivots Output array of size elements
+ * @param size Size of the matrix
+ * @return LU_SUCCESS or LU_SINGULAR if the matrix is singular
+ */
+#define LU_KERNEL_TYPE float
+#define LU_KERNEL_ABS fabsf
+#define LU_KERNEL_SWAP swapRowsFloat
+#define LU_KERNEL_FACTORIZE LUFactorizeFloat
+#include "lu_factorize_kernel.h"
+
+/**
+ * @brief Solve the system A * x = b from the single precision factorization
+ * of A computed by LUFactorizeFloat
+ *
+ * @param luMatrix The L and U matrices computed by LUFactorizeFloat
+ * @param pivots The pivots computed by LUFactorizeFloat
+ * @param size Size of the matrix
+ * @param vector The vector b. Will contain x
+ */
+void LUSolveFloat(const float* luMatrix, const int* pivots, const int size,
+                  float* vector) {
+  for (int i = 0; i < size; ++i) {
+    if (pivots[i] != i) {
+      float tmp = vector[i];
+      vector[i] = vector[pivots[i]];
+      vector[pivots[i]] = tmp;
+    }
+  }
+  for (int i = 1; i < size; ++i) {
+    for (int k = 0; k < i; ++k) {
+      vector[i] -= luMatrix[coordToIndex(i, k, size)] * vector[k];
+    }
+  }
+  for (int i = size - 1; i >= 0; --i) {
+    for (int k = i + 1; k < size; ++k) {
+      vector[i] -= luMatrix[coordToIndex(i, k, size)] * vector[k];
+    }
+    vector[i] /= luMatrix[coordToIndex(i, i, size)];
+  }
+}
+
+/**
+ * @brief Solve the system A * x = b to double precision accuracy with a
+ * single precision LU factorization and iterative refinement of the residual
+ * computed in double precision. When the refinement stagnates or does not
+ * converge, because the matrix is too ill-conditioned for single precision,
+ * the system is solved again with a double precision factorization, as well
+ * as when the matrix or the single precision solution is not finite. The
+ * factorized copy of the matrix is allocated on the heap.
+ *
+ * @param matrix The matrix A. It is not modified
+ * @param size Size of the matrix
+ * @param vector The vector b
+ * @param solution Output vector x
+ * @param tol The refinement stops when ||b - A * x|| <= tol * (||A|| * ||x||
+ * + ||b||), with infinity norms
+ * @param iterations Maximum number of refinement iterations. Will contain the
+ * number of refinement iterations done
+ * @return LU_SUCCESS, LU_DOUBLE_FALLBACK if the double precision solver was
+ * used, LU_SINGULAR if the matrix is singular or LU_ALLOCATION_ERROR if the
+ * copy of the matrix could not be allocated
+ */
+int LUSolveMixedPrecision(const lu_real* matrix, const int size,
+                          const lu_real* vector, lu_real* solution,
+                          const lu_real tol, int* iterations) {
+  const int maxIterations = *iterations;
+  *iterations = 0;
+
+  // Large enough for the double precision fallback, which reuses it
+  lu_real* highMatrix = (lu_real*)malloc((size_t)size * size * sizeof(lu_real));
+  if (highMatrix == NULL) {
+    return LU_ALLOCATION_ERROR;
+  }
+  float* lowMatrix = (float*)highMatrix;
+  float correction[size];
+  lu_real residual[size];
+  int pivots[size];
+
+  // Entries beyond the range of float, and everything computed from them,
+  // are not finite in single precision. The double precision solver is used
+  // instead
+  int finite = 1;
+  lu_real matrixNorm = 0;
+  lu_real vectorNorm = 0;
+  for (int i = 0; i < size; ++i) {
+    lu_real rowSum = 0;
+    for (int j = 0; j < size; ++j) {
+      rowSum += fabs(matrix[coordToIndex(i, j, size)]);
+      lowMatrix[coordToIndex(i, j, size)] = matrix[coordToIndex(i, j, size)];
+      if (!isfinite(lowMatrix[coordToIndex(i, j, size)])) {
+        finite = 0;
+      }
+    }
+    matrixNorm = rowSum > matrixNorm ? rowSum : matrixNorm;
+    vectorNorm = fabs(vector[i]) > vectorNorm ? fabs(vector[i]) : vectorNorm;
+  }
+
+  if (finite && LUFactorizeFloat(lowMatrix, pivots, size) == LU_SUCCESS) {
+    for (int i = 0; i < size; ++i) {
+      correction[i] = vector[i];
+    }
+    LUSolveFloat(lowMatrix, pivots, size, correction);
+    for (int i = 0; i < size; ++i) {
+      solution[i] = correction[i];
+      if (!isfinite(correction[i])) {
+        finite = 0;
+      }
+    }
+
+    lu_real previousNorm = INFINITY;
+    while (finite) {
+      // Residual in double precision
+      lu_real residualNorm = 0;
+      lu_real solutionNorm = 0;
+      for (int i = 0; i < size; ++i) {
+        residual[i] = vector[i];
+        for (int j = 0; j < size; ++j) {
+          residual[i] -= matrix[coordToIndex(i, j, size)] * solution[j];
+        }
+        if (!isfinite(residual[i]) || !isfinite(solution[i])) {
+          finite = 0;
+        }
+        residualNorm =
+            fabs(residual[i]) > residualNorm ? fabs(residual[i]) : residualNorm;
+        solutionNorm =
+            fabs(solution[i]) > solutionNorm ? fabs(solution[i]) : solutionNorm;
+      }
+      if (!finite) {
+        break;
+      }
+
+      if (residualNorm <= tol * (matrixNorm * solutionNorm + vectorNorm)) {
+        free(highMatrix);
+        return LU_SUCCESS;
+      }
+      // Each iteration must at least halve the residual to be worth it
+      if (*iterations >= maxIterations || !(residualNorm < previousNorm / 2)) {
+        break;
+      }
+      previousNorm = residualNorm;
+
+      // Correction in single precision
+      for (int i = 0; i < size; ++i) {
+        correction[i] = residual[i];
+      }
+      LUSolveFloat(lowMatrix, pivots, size, correction);
+      for (int i = 0; i < size; ++i) {
+        solution[i] += correction[i];
+      }
+      ++*iterations;
+    }
+  }
+
+  // Fall back to a double precision solve
+  memcpy(highMatrix, matrix, size * size * sizeof(lu_real));
+  int status = LU_DOUBLE_FALLBACK;
+  if (LUFactorize(highMatrix, pivots, size) == LU_SUCCESS) {
+    memcpy(solution, vector, size * sizeof(lu_real));
+    LUSolve(highMatrix, pivots, size, solution);
+  } else {
+    status = LU_SINGULAR;
+  }
+  free(highMatrix);
+  return status;
+}
@@ -3,12 +3,38 @@
 
 typedef double lu_real;
 
+#define LU_SUCCESS 0
+#define LU_SINGULAR 1
+#define LU_DOUBLE_FALLBACK 2
+#define LU_ALLOCATION_ERROR 3
+
+// Number of columns factorized together before updating the trailing matrix
+#ifndef LU_BLOCK_SIZE
+#define LU_BLOCK_SIZE 32
+#endif
+
+// Minimum size of the work under which OpenMP threads are not used
+#ifndef LU_PARALLEL_MIN_SIZE
+#define LU_PARALLEL_MIN_SIZE 128
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void LUDecomposition(const lu_real* initialMatrix, lu_real* lMatrix,
                      lu_real* uMatrix, const int size);
+int LUFactorize(lu_real* matrix, int* pivots, const int size);
+void LUSolve(const lu_real* luMatrix, const int* pivots, const int size,
+             lu_real* vector);
+void LUSolveMany(const lu_real* luMatrix, const int* pivots, const int size,
+                 lu_real* matrix, const int nbColumns);
+int LUFactorizeFloat(float* matrix, int* pivots, const int size);
+void LUSolveFloat(const float* luMatrix, const int* pivots, const int size,
+                  float* vector);
+int LUSolveMixedPrecision(const lu_real* matrix, const int size,
+                          const lu_real* vector, lu_real* solution,
+                          const lu_real tol, int* iterations);
 
 #ifdef __cplusplus
 }
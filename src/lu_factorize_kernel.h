@@ -0,0 +1,131 @@
+/*
+ * Blocked LU factorization with partial pivoting, written once for every
+ * precision. This file has no include guard: lu_decomposition.c includes it
+ * once per precision after defining
+ *   LU_KERNEL_TYPE      the type of the elements
+ *   LU_KERNEL_ABS       the absolute value function of that type
+ *   LU_KERNEL_SWAP      the name of the generated row swap function
+ *   LU_KERNEL_FACTORIZE the name of the generated factorization function
+ * The macros are undefined at the end of the file.
+ */
+
+/**
+ * @brief Swaps a range of columns between two rows of a matrix
+ *
+ * @param matrix The matrix
+ * @param row1 First row to swap
+ * @param row2 Second row to swap
+ * @param firstCol First column to swap
+ * @param lastCol Column after the last column to swap
+ * @param nbColumns Number of columns of the matrix
+ */
+static void LU_KERNEL_SWAP(LU_KERNEL_TYPE* matrix, const int row1,
+                           const int row2, const int firstCol,
+                           const int lastCol, const int nbColumns) {
+  LU_KERNEL_TYPE* first = &matrix[coordToIndex(row1, 0, nbColumns)];
+  LU_KERNEL_TYPE* second = &matrix[coordToIndex(row2, 0, nbColumns)];
+  for (int j = firstCol; j < lastCol; ++j) {
+    LU_KERNEL_TYPE tmp = first[j];
+    first[j] = second[j];
+    second[j] = tmp;
+  }
+}
+
+int LU_KERNEL_FACTORIZE(LU_KERNEL_TYPE* matrix, int* pivots, const int size) {
+  int status = LU_SUCCESS;
+
+  // A single parallel region for the whole factorization: the threads only
+  // synchronize at the end of each work-sharing loop
+#ifdef _OPENMP
+#pragma omp parallel if (size > LU_PARALLEL_MIN_SIZE)
+#endif
+  for (int k = 0; k < size; k += LU_BLOCK_SIZE) {
+    const int blockEnd = k + LU_BLOCK_SIZE < size ? k + LU_BLOCK_SIZE : size;
+
+    // Factorize the panel made of the columns k to blockEnd
+    for (int j = k; j < blockEnd; ++j) {
+#ifdef _OPENMP
+#pragma omp single
+#endif
+      {
+        int pivot = j;
+        for (int i = j + 1; i < size; ++i) {
+          if (LU_KERNEL_ABS(matrix[coordToIndex(i, j, size)]) >
+              LU_KERNEL_ABS(matrix[coordToIndex(pivot, j, size)])) {
+            pivot = i;
+          }
+        }
+        pivots[j] = pivot;
+        if (matrix[coordToIndex(pivot, j, size)] == 0) {
+          status = LU_SINGULAR;
+        } else if (pivot != j) {
+          LU_KERNEL_SWAP(matrix, j, pivot, 0, size, size);
+        }
+      }
+      // Every thread sees the status after the barrier of single
+      if (status != LU_SUCCESS) {
+        break;
+      }
+
+      // Rows below the pivot are independent
+      const LU_KERNEL_TYPE* pivotRow = &matrix[coordToIndex(j, 0, size)];
+#ifdef _OPENMP
+#pragma omp for
+#endif
+      for (int i = j + 1; i < size; ++i) {
+        LU_KERNEL_TYPE* row = &matrix[coordToIndex(i, 0, size)];
+        LU_KERNEL_TYPE factor = row[j] / pivotRow[j];
+        row[j] = factor;
+        for (int col = j + 1; col < blockEnd; ++col) {
+          row[col] -= factor * pivotRow[col];
+        }
+      }
+    }
+    if (status != LU_SUCCESS) {
+      break;
+    }
+
+    // Compute the block row of U on the right of the panel. Each group of
+    // columns is independent
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (int colStart = blockEnd; colStart < size; colStart += LU_BLOCK_SIZE) {
+      const int colEnd =
+          colStart + LU_BLOCK_SIZE < size ? colStart + LU_BLOCK_SIZE : size;
+      for (int j = k; j < blockEnd; ++j) {
+        const LU_KERNEL_TYPE* pivotRow = &matrix[coordToIndex(j, 0, size)];
+        for (int i = j + 1; i < blockEnd; ++i) {
+          LU_KERNEL_TYPE* row = &matrix[coordToIndex(i, 0, size)];
+          LU_KERNEL_TYPE factor = row[j];
+          for (int col = colStart; col < colEnd; ++col) {
+            row[col] -= factor * pivotRow[col];
+          }
+        }
+      }
+    }
+
+    // Update the trailing matrix with the product of the panel and the block
+    // row of U. Each row is independent
+#ifdef _OPENMP
+#pragma omp for
+#endif
+    for (int i = blockEnd; i < size; ++i) {
+      LU_KERNEL_TYPE* row = &matrix[coordToIndex(i, 0, size)];
+      for (int j = k; j < blockEnd; ++j) {
+        const LU_KERNEL_TYPE* pivotRow = &matrix[coordToIndex(j, 0, size)];
+        LU_KERNEL_TYPE factor = row[j];
+        for (int col = blockEnd; col < size; ++col) {
+          row[col] -= factor * pivotRow[col];
+        }
+      }
+    }
+  }
+
+  return status;
+}
+
+#undef LU_KERNEL_TYPE
+#undef LU_KERNEL_ABS
+#undef LU_KERNEL_SWAP
+#undef LU_KERNEL_FACTORIZE
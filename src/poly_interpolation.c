@@ -1,6 +1,7 @@
 /* This file is part of the 1chipML library. */
 
 #include "poly_interpolation.h"
+#include <limits.h>
 
 /*
   This function implements the polynomial interpolation or extrapolation
@@ -15,9 +16,10 @@ int poly_interpolation(poly_real x_a[], poly_real y_a[], unsigned int n,
   poly_real* py_a = y_a - 1;
 
   /* Create c and d vector to calculate differences c and d between
-    2 parents and 1 child. */
-  poly_real* c = (poly_real*)malloc((n + 1) * sizeof(poly_real));
-  poly_real* d = (poly_real*)malloc((n + 1) * sizeof(poly_real));
+    2 parents and 1 child. They live on the stack, so every return path
+    releases them. */
+  poly_real c[n + 1];
+  poly_real d[n + 1];
 
   /* Set the index as boundary if it is an extrapolation problem. */
   if (x <= px_a[1]) {
@@ -28,8 +30,8 @@ int poly_interpolation(poly_real x_a[], poly_real y_a[], unsigned int n,
 
   for (unsigned int i = 1; i <= n; i++) {
     /* Initialize the tableau of c and d as y_a. */
-    *(c + i) = py_a[i];
-    *(d + i) = py_a[i];
+    c[i] = py_a[i];
+    d[i] = py_a[i];
 
     /* If the input x is in measured data, just return the measured value. */
     if (x == px_a[i]) {
@@ -72,11 +74,127 @@ int poly_interpolation(poly_real x_a[], poly_real y_a[], unsigned int n,
     *y += *error;
   }
 
-  /* Free the memory. */
-  free(c);
-  free(d);
+  return 0;
+}
+
+/*
+  This function precomputes the barycentric weights
+  w_i = 1 / prod_{j != i} (x_i - x_j) of the measured data, so that the
+  interpolating polynomial can then be evaluated in O(n).
+  The barycentric formula does not change when every weight is multiplied by
+  the same factor, so the products are kept as a mantissa and a power of 2,
+  which never overflow nor underflow, and the weights are then divided by the
+  largest one.
+  */
+int poly_interpolant_build(poly_interpolant* interpolant,
+                           const poly_real x_a[], const poly_real y_a[],
+                           unsigned int n, poly_real weights[]) {
+  int exponents[n > 0 ? n : 1];
+  int largest_exponent = INT_MIN;
+  for (unsigned int i = 0; i < n; i++) {
+    poly_real product = 1.;
+    int exponent = 0;
+    for (unsigned int j = 0; j < n; j++) {
+      if (j != i) {
+        if (x_a[i] == x_a[j]) {
+          return -1;
+        }
+        int shift;
+        product = frexp(product * (x_a[i] - x_a[j]), &shift);
+        exponent += shift;
+      }
+    }
+    weights[i] = 1. / product;
+    exponents[i] = -exponent;
+    if (exponents[i] > largest_exponent) {
+      largest_exponent = exponents[i];
+    }
+  }
 
+  poly_real largest = 0.;
+  for (unsigned int i = 0; i < n; i++) {
+    weights[i] = ldexp(weights[i], exponents[i] - largest_exponent);
+    largest = fabs(weights[i]) > largest ? fabs(weights[i]) : largest;
+  }
+  for (unsigned int i = 0; i < n; i++) {
+    weights[i] /= largest;
+  }
+
+  interpolant->n = n;
+  interpolant->x_a = x_a;
+  interpolant->y_a = y_a;
+  interpolant->weights = weights;
   return 0;
 }
 
+/*
+  This function evaluates the interpolating polynomial with the second
+  (true) barycentric formula
+  p(x) = sum(w_i * y_i / (x - x_i)) / sum(w_i / (x - x_i)).
+  */
+poly_real poly_interpolant_eval(const poly_interpolant* interpolant,
+                                poly_real x) {
+  poly_real numerator = 0.;
+  poly_real denominator = 0.;
+
+  for (unsigned int i = 0; i < interpolant->n; i++) {
+    poly_real difference = x - interpolant->x_a[i];
+
+    /* If the input x is in measured data, just return the measured value. */
+    if (difference == 0) {
+      return interpolant->y_a[i];
+    }
+
+    poly_real term = interpolant->weights[i] / difference;
+    numerator += term * interpolant->y_a[i];
+    denominator += term;
+  }
+
+  return numerator / denominator;
+}
+
+/*
+  This function evaluates the interpolating polynomial at count points.
+  The points are processed by chunks with the loop over the points innermost,
+  so that the compiler can vectorize it.
+  */
+void poly_interpolant_eval_batch(const poly_interpolant* interpolant,
+                                 const poly_real x[], poly_real y[],
+                                 unsigned int count) {
+  poly_real numerator[POLY_BATCH_CHUNK];
+  poly_real denominator[POLY_BATCH_CHUNK];
+  int exact[POLY_BATCH_CHUNK];
+
+  for (unsigned int start = 0; start < count; start += POLY_BATCH_CHUNK) {
+    unsigned int size =
+        count - start < POLY_BATCH_CHUNK ? count - start : POLY_BATCH_CHUNK;
+    const poly_real* chunk = x + start;
+
+    for (unsigned int j = 0; j < size; j++) {
+      numerator[j] = 0.;
+      denominator[j] = 0.;
+      exact[j] = -1;
+    }
+
+    for (unsigned int i = 0; i < interpolant->n; i++) {
+      poly_real x_i = interpolant->x_a[i];
+      poly_real w_i = interpolant->weights[i];
+      poly_real y_i = interpolant->y_a[i];
+      for (unsigned int j = 0; j < size; j++) {
+        poly_real difference = chunk[j] - x_i;
+        /* Measured points are remembered and fixed after the loop. */
+        exact[j] = difference == 0 ? (int)i : exact[j];
+        poly_real term = w_i / difference;
+        numerator[j] += term * y_i;
+        denominator[j] += term;
+      }
+    }
+
+    for (unsigned int j = 0; j < size; j++) {
+      y[start + j] = exact[j] >= 0 ? interpolant->y_a[exact[j]]
+                                   : numerator[j] / denominator[j];
+    }
+  }
+}
+
 /* -- End of file -- */
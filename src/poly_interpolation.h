@@ -1,4 +1,7 @@
 /* This file is part of the 1chipML library. */
+#ifndef POLY_INTERPOLATION_H
+#define POLY_INTERPOLATION_H
+
 #ifndef _BASE_LIB_
 #define _BASE_LIB_
 
@@ -16,6 +19,25 @@
 
 #define poly_real double
 
+/*
+ * Number of points evaluated together by poly_interpolant_eval_batch.
+ */
+#ifndef POLY_BATCH_CHUNK
+#define POLY_BATCH_CHUNK 64
+#endif
+
+/*
+ * Interpolating polynomial in barycentric form, built once by
+ * poly_interpolant_build. It keeps pointers to the measured data and to the
+ * weights, which must outlive it.
+ */
+typedef struct {
+  unsigned int n;
+  const poly_real* x_a;
+  const poly_real* y_a;
+  const poly_real* weights;
+} poly_interpolant;
+
 /* Functions are declared below */
 
 /*
@@ -35,4 +57,48 @@
 int poly_interpolation(poly_real x_a[], poly_real y_a[], unsigned int n,
                        poly_real x, poly_real* y, poly_real* error);
 
+/*
+ * This function builds the barycentric form of the polynomial going through
+ * the measured data in O(n^2), without allocating memory. It is meant to be
+ * evaluated many times with poly_interpolant_eval.
+ * Input:
+ *	x_a: Measured x values. They have to be distinct.
+ *	y_a: Measured y values pairing with x values.
+ *	n: The number of measured data.
+ *	weights: Array of n elements that receives the barycentric weights.
+ * Output:
+ *	interpolant: The interpolant to evaluate.
+ * Return:
+ *	0 as success, and -1 as error.
+ */
+int poly_interpolant_build(poly_interpolant* interpolant,
+                           const poly_real x_a[], const poly_real y_a[],
+                           unsigned int n, poly_real weights[]);
+
+/*
+ * This function evaluates the interpolant in O(n).
+ * Input:
+ *	interpolant: The interpolant built by poly_interpolant_build.
+ *	x: The x value of the data to be interpolated/extrapolated.
+ * Return:
+ *	The y value of the data to be interpolated/extrapolated.
+ */
+poly_real poly_interpolant_eval(const poly_interpolant* interpolant,
+                                poly_real x);
+
+/*
+ * This function evaluates the interpolant at several points at once.
+ * Input:
+ *	interpolant: The interpolant built by poly_interpolant_build.
+ *	x: The x values of the data to be interpolated/extrapolated.
+ *	count: The number of x values.
+ * Output:
+ *	y: The count y values of the data to be interpolated/extrapolated.
+ */
+void poly_interpolant_eval_batch(const poly_interpolant* interpolant,
+                                 const poly_real x[], poly_real y[],
+                                 unsigned int count);
+
+#endif
+
 /* -- End of file -- */
@@ -0,0 +1,225 @@
+#include "qr_decomposition.h"
+#include "matrix.h"
+#include <math.h>
+
+/**
+ * @brief Apply the Householder reflector H = I - tau * v * v^T stored in
+ * column col of the factorized matrix to a range of columns of a target
+ * matrix. v has an implicit 1 at row col and is null above it.
+ *
+ * @param qrMatrix The matrix computed by QRFactorize
+ * @param nbRows Number of rows of both matrices
+ * @param nbColumns Number of columns of qrMatrix
+ * @param col Column holding the reflector
+ * @param tau Scale of the reflector
+ * @param target The matrix to update
+ * @param targetColumns Number of columns of target
+ * @param firstCol First column of target to update
+ * @param lastCol Column after the last column of target to update. At most
+ * QR_BLOCK_SIZE columns are updated at once
+ */
+static void applyReflector(const qr_real* qrMatrix, const int nbRows,
+                           const int nbColumns, const int col,
+                           const qr_real tau, qr_real* target,
+                           const int targetColumns, const int firstCol,
+                           const int lastCol) {
+  if (tau == 0) {
+    return;
+  }
+
+  // w = v^T * target, accumulated row by row to follow the memory layout
+  qr_real w[QR_BLOCK_SIZE];
+  const qr_real* row = &target[coordToIndex(col, 0, targetColumns)];
+  for (int j = firstCol; j < lastCol; ++j) {
+    w[j - firstCol] = row[j];
+  }
+  for (int i = col + 1; i < nbRows; ++i) {
+    qr_real v = qrMatrix[coordToIndex(i, col, nbColumns)];
+    row = &target[coordToIndex(i, 0, targetColumns)];
+    for (int j = firstCol; j < lastCol; ++j) {
+      w[j - firstCol] += v * row[j];
+    }
+  }
+
+  // target -= tau * v * w^T
+  qr_real* updated = &target[coordToIndex(col, 0, targetColumns)];
+  for (int j = firstCol; j < lastCol; ++j) {
+    updated[j] -= tau * w[j - firstCol];
+  }
+  for (int i = col + 1; i < nbRows; ++i) {
+    qr_real v = tau * qrMatrix[coordToIndex(i, col, nbColumns)];
+    updated = &target[coordToIndex(i, 0, targetColumns)];
+    for (int j = firstCol; j < lastCol; ++j) {
+      updated[j] -= v * w[j - firstCol];
+    }
+  }
+}
+
+/**
+ * @brief Perform the blocked Householder QR decomposition of a nbRows x
+ * nbColumns matrix in place, with nbRows >= nbColumns. After the call, the
+ * upper triangle contains R and the part below the diagonal contains the
+ * Householder vectors, whose first element is an implicit 1, so that
+ * A = Q * R with Q = H(0) * H(1) * ... * H(nbColumns - 1) and
+ * H(j) = I - tau[j] * v(j) * v(j)^T.
+ * The reflectors of a panel of QR_BLOCK_SIZE columns are applied to the
+ * trailing matrix group of columns by group of columns, which keeps the
+ * panel in cache without allocating the workspace of a compact WY form.
+ *
+ * @param matrix The matrix to decompose. Will contain R and the reflectors
+ * @param nbRows Number of rows of the matrix
+ * @param nbColumns Number of columns of the matrix
+ * @param tau Output array of nbColumns elements. Scales of the reflectors
+ * @return QR_SUCCESS or QR_INVALID_SIZE if nbRows < nbColumns
+ */
+int QRFactorize(qr_real* matrix, const int nbRows, const int nbColumns,
+                qr_real* tau) {
+  if (nbRows < nbColumns) {
+    return QR_INVALID_SIZE;
+  }
+
+  for (int k = 0; k < nbColumns; k += QR_BLOCK_SIZE) {
+    const int blockEnd =
+        k + QR_BLOCK_SIZE < nbColumns ? k + QR_BLOCK_SIZE : nbColumns;
+
+    // Factorize the panel made of the columns k to blockEnd
+    for (int j = k; j < blockEnd; ++j) {
+      qr_real alpha = matrix[coordToIndex(j, j, nbColumns)];
+      qr_real tailNorm = 0;
+      for (int i = j + 1; i < nbRows; ++i) {
+        qr_real element = matrix[coordToIndex(i, j, nbColumns)];
+        tailNorm += element * element;
+      }
+
+      if (tailNorm == 0) {
+        // The column is already reduced
+        tau[j] = 0;
+      } else {
+        qr_real beta = sqrt(alpha * alpha + tailNorm);
+        if (alpha > 0) {
+          beta = -beta;
+        }
+        tau[j] = (beta - alpha) / beta;
+        qr_real scale = 1 / (alpha - beta);
+        for (int i = j + 1; i < nbRows; ++i) {
+          matrix[coordToIndex(i, j, nbColumns)] *= scale;
+        }
+        matrix[coordToIndex(j, j, nbColumns)] = beta;
+      }
+
+      applyReflector(matrix, nbRows, nbColumns, j, tau[j], matrix, nbColumns,
+                     j + 1, blockEnd);
+    }
+
+    // Apply the reflectors of the panel to the trailing matrix
+    for (int colStart = blockEnd; colStart < nbColumns;
+         colStart += QR_BLOCK_SIZE) {
+      const int colEnd = colStart + QR_BLOCK_SIZE < nbColumns
+                             ? colStart + QR_BLOCK_SIZE
+                             : nbColumns;
+      for (int j = k; j < blockEnd; ++j) {
+        applyReflector(matrix, nbRows, nbColumns, j, tau[j], matrix,
+                       nbColumns, colStart, colEnd);
+      }
+    }
+  }
+
+  return QR_SUCCESS;
+}
+
+/**
+ * @brief Compute Q^T * B from the factorization computed by QRFactorize
+ *
+ * @param qrMatrix The matrix computed by QRFactorize
+ * @param tau The scales computed by QRFactorize
+ * @param nbRows Number of rows of the factorized matrix
+ * @param nbColumns Number of columns of the factorized matrix
+ * @param matrix The nbRows x nbRhs matrix B. Will contain Q^T * B
+ * @param nbRhs Number of columns of B
+ */
+void QRApplyQTranspose(const qr_real* qrMatrix, const qr_real* tau,
+                       const int nbRows, const int nbColumns, qr_real* matrix,
+                       const int nbRhs) {
+  for (int colStart = 0; colStart < nbRhs; colStart += QR_BLOCK_SIZE) {
+    const int colEnd =
+        colStart + QR_BLOCK_SIZE < nbRhs ? colStart + QR_BLOCK_SIZE : nbRhs;
+    for (int j = 0; j < nbColumns; ++j) {
+      applyReflector(qrMatrix, nbRows, nbColumns, j, tau[j], matrix, nbRhs,
+                     colStart, colEnd);
+    }
+  }
+}
+
+/**
+ * @brief Solve the least-squares problem min ||A * X - B|| from the
+ * factorization of A computed by QRFactorize
+ *
+ * @param qrMatrix The matrix computed by QRFactorize
+ * @param tau The scales computed by QRFactorize
+ * @param nbRows Number of rows of A
+ * @param nbColumns Number of columns of A
+ * @param matrix The nbRows x nbRhs matrix B. Its first nbColumns rows will
+ * contain X and the norm of each column of the remaining rows is the norm of
+ * the corresponding residual
+ * @param nbRhs Number of columns of B
+ * @return QR_SUCCESS or QR_RANK_DEFICIENT if a diagonal element of R is
+ * negligible compared to the largest one
+ */
+int QRSolve(const qr_real* qrMatrix, const qr_real* tau, const int nbRows,
+            const int nbColumns, qr_real* matrix, const int nbRhs) {
+  qr_real largest = 0;
+  for (int i = 0; i < nbColumns; ++i) {
+    qr_real diagonal = fabs(qrMatrix[coordToIndex(i, i, nbColumns)]);
+    largest = diagonal > largest ? diagonal : largest;
+  }
+  for (int i = 0; i < nbColumns; ++i) {
+    if (fabs(qrMatrix[coordToIndex(i, i, nbColumns)]) <=
+        QR_RANK_TOLERANCE * largest) {
+      return QR_RANK_DEFICIENT;
+    }
+  }
+
+  QRApplyQTranspose(qrMatrix, tau, nbRows, nbColumns, matrix, nbRhs);
+
+  // Backward substitution R * X = (Q^T * B)[0:nbColumns]
+  for (int i = nbColumns - 1; i >= 0; --i) {
+    qr_real* row = &matrix[coordToIndex(i, 0, nbRhs)];
+    for (int k = i + 1; k < nbColumns; ++k) {
+      qr_real factor = qrMatrix[coordToIndex(i, k, nbColumns)];
+      const qr_real* solved = &matrix[coordToIndex(k, 0, nbRhs)];
+      for (int j = 0; j < nbRhs; ++j) {
+        row[j] -= factor * solved[j];
+      }
+    }
+    qr_real diagonal = qrMatrix[coordToIndex(i, i, nbColumns)];
+    for (int j = 0; j < nbRhs; ++j) {
+      row[j] /= diagonal;
+    }
+  }
+
+  return QR_SUCCESS;
+}
+
+/**
+ * @brief Solve the linear least-squares problem min ||A * X - B|| for one or
+ * several right-hand sides with a Householder QR decomposition
+ *
+ * @param matrix The nbRows x nbColumns matrix A. Will contain its QR
+ * decomposition
+ * @param nbRows Number of rows of A
+ * @param nbColumns Number of columns of A
+ * @param rhs The nbRows x nbRhs matrix B. Its first nbColumns rows will
+ * contain X
+ * @param nbRhs Number of columns of B
+ * @return QR_SUCCESS, QR_INVALID_SIZE if nbRows < nbColumns or
+ * QR_RANK_DEFICIENT if the columns of A are linearly dependent
+ */
+int leastSquares(qr_real* matrix, const int nbRows, const int nbColumns,
+                 qr_real* rhs, const int nbRhs) {
+  if (nbRows < nbColumns) {
+    return QR_INVALID_SIZE;
+  }
+  qr_real tau[nbColumns];
+  QRFactorize(matrix, nbRows, nbColumns, tau);
+  return QRSolve(matrix, tau, nbRows, nbColumns, rhs, nbRhs);
+}
@@ -0,0 +1,38 @@
+#ifndef QR_DECOMPOSITION_H
+#define QR_DECOMPOSITION_H
+
+typedef double qr_real;
+
+#define QR_SUCCESS 0
+#define QR_RANK_DEFICIENT 1
+#define QR_INVALID_SIZE 2
+
+// Number of columns factorized together before updating the trailing matrix
+#ifndef QR_BLOCK_SIZE
+#define QR_BLOCK_SIZE 32
+#endif
+
+// Relative size of a diagonal element of R under which A is rank deficient
+#ifndef QR_RANK_TOLERANCE
+#define QR_RANK_TOLERANCE 1e-12
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int QRFactorize(qr_real* matrix, const int nbRows, const int nbColumns,
+                qr_real* tau);
+void QRApplyQTranspose(const qr_real* qrMatrix, const qr_real* tau,
+                       const int nbRows, const int nbColumns, qr_real* matrix,
+                       const int nbRhs);
+int QRSolve(const qr_real* qrMatrix, const qr_real* tau, const int nbRows,
+            const int nbColumns, qr_real* matrix, const int nbRhs);
+int leastSquares(qr_real* matrix, const int nbRows, const int nbColumns,
+                 qr_real* rhs, const int nbRhs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,199 @@
+/* This file is part of the 1chipML library. */
+
+#include "spline_interpolation.h"
+
+/*
+  This function computes the slope at the first or the last measured point
+  of a monotone spline with a shape-preserving three-point formula.
+  h0, delta0 belong to the end segment and h1, delta1 to its neighbour.
+  */
+static spline_real pchip_end_slope(spline_real h0, spline_real h1,
+                                   spline_real delta0, spline_real delta1) {
+  spline_real slope = ((2. * h0 + h1) * delta0 - h0 * delta1) / (h0 + h1);
+
+  if (slope * delta0 <= 0) {
+    slope = 0.;
+  } else if (delta0 * delta1 < 0 && fabs(slope) > fabs(3. * delta0)) {
+    slope = 3. * delta0;
+  }
+  return slope;
+}
+
+/*
+  This function computes the slopes of a monotone piecewise cubic Hermite
+  interpolation (Fritsch-Butland weighted harmonic mean).
+  */
+static void pchip_slopes(const spline_real x_a[], const spline_real y_a[],
+                         unsigned int n, spline_real slopes[]) {
+  spline_real h0 = x_a[1] - x_a[0];
+  spline_real delta0 = (y_a[1] - y_a[0]) / h0;
+
+  if (n == 2) {
+    slopes[0] = delta0;
+    slopes[1] = delta0;
+    return;
+  }
+
+  for (unsigned int i = 1; i < n - 1; i++) {
+    spline_real h1 = x_a[i + 1] - x_a[i];
+    spline_real delta1 = (y_a[i + 1] - y_a[i]) / h1;
+
+    /* Local extremum: a flat slope avoids any overshoot. */
+    if (delta0 * delta1 <= 0) {
+      slopes[i] = 0.;
+    } else {
+      spline_real w1 = 2. * h1 + h0;
+      spline_real w2 = h1 + 2. * h0;
+      slopes[i] = (w1 + w2) / (w1 / delta0 + w2 / delta1);
+    }
+
+    if (i == 1) {
+      slopes[0] = pchip_end_slope(h0, h1, delta0, delta1);
+    }
+    if (i == n - 2) {
+      slopes[n - 1] = pchip_end_slope(h1, h0, delta1, delta0);
+    }
+    h0 = h1;
+    delta0 = delta1;
+  }
+}
+
+/*
+  This function computes the slopes of a C2 cubic spline by solving the
+  tridiagonal system of the continuity of the second derivative with the
+  Thomas algorithm.
+  */
+static void cubic_spline_slopes(const spline_real x_a[],
+                                const spline_real y_a[], unsigned int n,
+                                spline_type type, spline_real left_slope,
+                                spline_real right_slope,
+                                spline_real slopes[]) {
+  /* Modified upper diagonal of the forward sweep. */
+  spline_real upper[n];
+  spline_real h0 = x_a[1] - x_a[0];
+  spline_real delta0 = (y_a[1] - y_a[0]) / h0;
+
+  /* First row, slopes[] holds the modified right-hand side. */
+  if (type == ClampedSpline) {
+    upper[0] = 0.;
+    slopes[0] = left_slope;
+  } else {
+    upper[0] = 0.5;
+    slopes[0] = 1.5 * delta0;
+  }
+
+  for (unsigned int i = 1; i < n - 1; i++) {
+    spline_real h1 = x_a[i + 1] - x_a[i];
+    spline_real delta1 = (y_a[i + 1] - y_a[i]) / h1;
+    spline_real lower = h1;
+    spline_real diagonal = 2. * (h0 + h1) - lower * upper[i - 1];
+    upper[i] = h0 / diagonal;
+    slopes[i] =
+        (3. * (h1 * delta0 + h0 * delta1) - lower * slopes[i - 1]) / diagonal;
+    h0 = h1;
+    delta0 = delta1;
+  }
+
+  /* Last row. */
+  if (type == ClampedSpline) {
+    slopes[n - 1] = right_slope;
+  } else {
+    slopes[n - 1] = (3. * delta0 - slopes[n - 2]) / (2. - upper[n - 2]);
+  }
+
+  /* Back substitution. */
+  for (unsigned int i = n - 1; i-- > 0;) {
+    slopes[i] -= upper[i] * slopes[i + 1];
+  }
+}
+
+int spline_build(spline* curve, const spline_real x_a[],
+                 const spline_real y_a[], unsigned int n, spline_type type,
+                 spline_real left_slope, spline_real right_slope,
+                 spline_real slopes[]) {
+  if (n < 2) {
+    return -1;
+  }
+  for (unsigned int i = 0; i < n - 1; i++) {
+    if (!(x_a[i] < x_a[i + 1])) {
+      return -1;
+    }
+  }
+
+  if (type == MonotoneSpline) {
+    pchip_slopes(x_a, y_a, n, slopes);
+  } else {
+    cubic_spline_slopes(x_a, y_a, n, type, left_slope, right_slope, slopes);
+  }
+
+  curve->n = n;
+  curve->x_a = x_a;
+  curve->y_a = y_a;
+  curve->slopes = slopes;
+  return 0;
+}
+
+unsigned int spline_find_segment(const spline* curve, spline_real x) {
+  unsigned int low = 0;
+  unsigned int high = curve->n - 1;
+
+  /* Invariant: x_a[low] <= x < x_a[high], except outside of the data. */
+  while (high - low > 1) {
+    unsigned int middle = low + (high - low) / 2;
+    if (x < curve->x_a[middle]) {
+      high = middle;
+    } else {
+      low = middle;
+    }
+  }
+  return low;
+}
+
+/*
+  This function evaluates the cubic Hermite polynomial of a segment.
+  */
+static spline_real eval_segment(const spline* curve, unsigned int segment,
+                                spline_real x) {
+  spline_real h = curve->x_a[segment + 1] - curve->x_a[segment];
+  spline_real t = (x - curve->x_a[segment]) / h;
+  spline_real y0 = curve->y_a[segment];
+  spline_real y1 = curve->y_a[segment + 1];
+  spline_real d0 = h * curve->slopes[segment];
+  spline_real d1 = h * curve->slopes[segment + 1];
+
+  /* Horner form of the Hermite basis combination. */
+  spline_real c2 = 3. * (y1 - y0) - 2. * d0 - d1;
+  spline_real c3 = 2. * (y0 - y1) + d0 + d1;
+  return y0 + t * (d0 + t * (c2 + t * c3));
+}
+
+spline_real spline_eval(const spline* curve, spline_real x) {
+  return eval_segment(curve, spline_find_segment(curve, x), x);
+}
+
+void spline_stream_init(spline_stream* stream, const spline* curve) {
+  stream->curve = curve;
+  stream->segment = 0;
+}
+
+spline_real spline_stream_eval(spline_stream* stream, spline_real x) {
+  const spline* curve = stream->curve;
+  unsigned int segment = stream->segment;
+  const unsigned int last = curve->n - 2;
+
+  /* Stay in the cached segment, or move to the next one, before falling
+     back to a binary search. */
+  if ((segment > 0 && x < curve->x_a[segment]) ||
+      (segment < last && x >= curve->x_a[segment + 1])) {
+    if (segment < last && x >= curve->x_a[segment + 1] &&
+        (segment + 1 == last || x < curve->x_a[segment + 2])) {
+      segment++;
+    } else {
+      segment = spline_find_segment(curve, x);
+    }
+    stream->segment = segment;
+  }
+  return eval_segment(curve, segment, x);
+}
+
+/* -- End of file -- */
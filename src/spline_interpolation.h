@@ -0,0 +1,93 @@
+/* This file is part of the 1chipML library. */
+#ifndef _SPLINE_INTERPOLATION_
+#define _SPLINE_INTERPOLATION_
+
+#include <math.h>
+
+/*
+ * The definition below can take the values "float" or "double"
+ * and defines the precision of the variables used in the spline
+ * interpolation method.
+ */
+
+#define spline_real double
+
+/*
+ * Kind of piecewise cubic interpolation:
+ *	NaturalSpline: C2 spline with null second derivatives at both ends.
+ *	ClampedSpline: C2 spline with the first derivatives given at both ends.
+ *	MonotoneSpline: C1 monotone piecewise cubic Hermite interpolation (PCHIP),
+ *	which does not overshoot the measured data.
+ */
+typedef enum { NaturalSpline, ClampedSpline, MonotoneSpline } spline_type;
+
+/*
+ * Piecewise cubic in Hermite form, built by spline_build. It keeps pointers
+ * to the measured data and to the slopes, which must outlive it.
+ */
+typedef struct {
+  unsigned int n;
+  const spline_real* x_a;
+  const spline_real* y_a;
+  const spline_real* slopes;
+} spline;
+
+/*
+ * Evaluator remembering the last segment used, for increasing queries.
+ */
+typedef struct {
+  const spline* curve;
+  unsigned int segment;
+} spline_stream;
+
+/* Functions are declared below */
+
+/*
+ * This function builds the piecewise cubic going through the measured data
+ * in O(n) by computing the first derivative at every measured point.
+ * Input:
+ *	x_a: Measured x values. They have to be strictly increasing.
+ *	y_a: Measured y values pairing with x values.
+ *	n: The number of measured data, at least 2.
+ *	type: The kind of interpolation.
+ *	left_slope, right_slope: The first derivatives at both ends. They are
+ *	only used by ClampedSpline.
+ *	slopes: Array of n elements that receives the first derivatives.
+ * Output:
+ *	curve: The spline to evaluate.
+ * Return:
+ *	0 as success, and -1 as error.
+ */
+int spline_build(spline* curve, const spline_real x_a[],
+                 const spline_real y_a[], unsigned int n, spline_type type,
+                 spline_real left_slope, spline_real right_slope,
+                 spline_real slopes[]);
+
+/*
+ * This function finds the segment [x_a[i], x_a[i + 1]] containing x with a
+ * binary search in O(log n). Values outside of the measured data use the
+ * first or the last segment.
+ */
+unsigned int spline_find_segment(const spline* curve, spline_real x);
+
+/*
+ * This function evaluates the spline at x. Values outside of the measured
+ * data are extrapolated with the first or the last cubic.
+ */
+spline_real spline_eval(const spline* curve, spline_real x);
+
+/*
+ * This function prepares a streaming evaluator starting at the first segment.
+ */
+void spline_stream_init(spline_stream* stream, const spline* curve);
+
+/*
+ * This function evaluates the spline at x, in O(1) when x lies in the same
+ * segment as the previous query or in the next one, and in O(log n)
+ * otherwise.
+ */
+spline_real spline_stream_eval(spline_stream* stream, spline_real x);
+
+#endif
+
+/* -- End of file -- */
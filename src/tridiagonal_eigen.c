@@ -0,0 +1,153 @@
+#include "tridiagonal_eigen.h"
+#include "matrix.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief Sorts the eigen values in decreasing order along with the columns of
+ * the eigen vectors matrix
+ *
+ * @param eigenValues The eigen values to sort
+ * @param eigenVectors Matrix containing the eigen vectors as columns. Can be
+ * NULL
+ * @param size Number of eigen values
+ */
+static void sortEigenPairs(tridiagonal_real* eigenValues,
+                           tridiagonal_real* eigenVectors, const int size) {
+  for (int i = 0; i < size; ++i) {
+    int maxIndex = i;
+    for (int j = i + 1; j < size; ++j) {
+      if (eigenValues[j] > eigenValues[maxIndex]) {
+        maxIndex = j;
+      }
+    }
+    if (maxIndex == i) {
+      continue;
+    }
+
+    tridiagonal_real tmp = eigenValues[i];
+    eigenValues[i] = eigenValues[maxIndex];
+    eigenValues[maxIndex] = tmp;
+    if (eigenVectors != NULL) {
+      for (int k = 0; k < size; ++k) {
+        tmp = eigenVectors[coordToIndex(k, i, size)];
+        eigenVectors[coordToIndex(k, i, size)] =
+            eigenVectors[coordToIndex(k, maxIndex, size)];
+        eigenVectors[coordToIndex(k, maxIndex, size)] = tmp;
+      }
+    }
+  }
+}
+
+/**
+ * @brief Computes the eigen values and optionally the eigen vectors of a
+ * symmetric tridiagonal matrix using the QL algorithm with implicit shifts.
+ * This is the matrix T produced by the Lanczos algorithm, where the diagonal
+ * contains the alpha values and the off diagonal the beta values.
+ * Eigen values alone are found in O(size^2) operations.
+ *
+ * Based on :
+ * http://www.it.uom.gr/teaching/linearalgebra/NumericalRecipiesInC/c11-3.pdf
+ *
+ * @param diagonal The size elements of the diagonal. Will contain the eigen
+ * values in decreasing order after the function executes
+ * @param offDiagonal The size - 1 elements next to the diagonal
+ * @param size Size of the matrix
+ * @param eigenVectors Output matrix of size * size containing the eigen vector
+ * associated to each eigen value as columns. Set to NULL to only compute the
+ * eigen values
+ * @return TRIDIAGONAL_SUCCESS or TRIDIAGONAL_ERROR if an eigen value did not
+ * converge
+ */
+int tridiagonalEigen(tridiagonal_real* diagonal,
+                     const tridiagonal_real* offDiagonal, const int size,
+                     tridiagonal_real* eigenVectors) {
+  // A 1 x 1 matrix is its own eigen value, with a unit eigen vector
+  if (size <= 1) {
+    if (size == 1 && eigenVectors != NULL) {
+      eigenVectors[0] = 1.0;
+    }
+    return TRIDIAGONAL_SUCCESS;
+  }
+
+  tridiagonal_real* d = diagonal;
+  // The last element is only used as a sentinel by the algorithm
+  tridiagonal_real e[size];
+  memcpy(e, offDiagonal, (size - 1) * sizeof(tridiagonal_real));
+  e[size - 1] = 0.0;
+
+  if (eigenVectors != NULL) {
+    createIdentityMatrix(size, eigenVectors);
+  }
+
+  for (int l = 0; l < size; ++l) {
+    int iterations = 0;
+    int m;
+    do {
+      // Look for a single small off diagonal element to split the matrix
+      for (m = l; m < size - 1; ++m) {
+        tridiagonal_real dd = fabs(d[m]) + fabs(d[m + 1]);
+        if (fabs(e[m]) <= DBL_EPSILON * dd) {
+          break;
+        }
+      }
+      if (m == l) {
+        continue;
+      }
+
+      if (iterations++ == TRIDIAGONAL_MAX_ITERATIONS) {
+        return TRIDIAGONAL_ERROR;
+      }
+
+      // Form the shift
+      tridiagonal_real g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+      tridiagonal_real r = hypot(g, 1.0);
+      g = d[m] - d[l] + e[l] / (g + (g >= 0.0 ? fabs(r) : -fabs(r)));
+
+      tridiagonal_real s = 1.0;
+      tridiagonal_real c = 1.0;
+      tridiagonal_real p = 0.0;
+      int i;
+      // A plane rotation followed by Givens rotations to restore the
+      // tridiagonal form
+      for (i = m - 1; i >= l; --i) {
+        tridiagonal_real f = s * e[i];
+        tridiagonal_real b = c * e[i];
+        r = hypot(f, g);
+        e[i + 1] = r;
+        if (r == 0.0) {
+          // Recover from underflow
+          d[i + 1] -= p;
+          e[m] = 0.0;
+          break;
+        }
+        s = f / r;
+        c = g / r;
+        g = d[i + 1] - p;
+        r = (d[i] - g) * s + 2.0 * c * b;
+        p = s * r;
+        d[i + 1] = g + p;
+        g = c * r - b;
+
+        if (eigenVectors != NULL) {
+          for (int k = 0; k < size; ++k) {
+            tridiagonal_real* zi = &eigenVectors[coordToIndex(k, i, size)];
+            f = zi[1];
+            zi[1] = s * zi[0] + c * f;
+            zi[0] = c * zi[0] - s * f;
+          }
+        }
+      }
+      if (r == 0.0 && i >= l) {
+        continue;
+      }
+      d[l] -= p;
+      e[l] = g;
+      e[m] = 0.0;
+    } while (m != l);
+  }
+
+  sortEigenPairs(diagonal, eigenVectors, size);
+  return TRIDIAGONAL_SUCCESS;
+}
@@ -0,0 +1,26 @@
+#ifndef TRIDIAGONAL_EIGEN_H
+#define TRIDIAGONAL_EIGEN_H
+
+typedef double tridiagonal_real;
+
+#define TRIDIAGONAL_SUCCESS 0
+#define TRIDIAGONAL_ERROR 1
+
+// Limit the number of implicit QL iterations done for each eigen value
+#ifndef TRIDIAGONAL_MAX_ITERATIONS
+#define TRIDIAGONAL_MAX_ITERATIONS 30
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int tridiagonalEigen(tridiagonal_real* diagonal,
+                     const tridiagonal_real* offDiagonal, const int size,
+                     tridiagonal_real* eigenVectors);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,203 @@
+#include <autodiff.h>
+#include <gradient_descent.h>
+#include <math.h>
+#include <stdio.h>
+
+#define N 4
+#define LARGE_N 1000
+#define TOL 1e-12
+
+static int isAlmostEqual(const autodiff_real* value,
+                         const autodiff_real* expected, int n,
+                         double tolerance) {
+
+  for (int i = 0; i < n; i++) {
+    if (fabs(value[i] - expected[i]) > tolerance * (1 + fabs(expected[i]))) {
+      printf("Fail: Expected %f got %f\n", expected[i], value[i]);
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+// Rosenbrock function plus a few transcendental terms, written once for every
+// kind of number
+#define OBJECTIVE(K)                                                         \
+  static AD_TYPE(K) objective##K(AD_TYPE(K) x[]) {                           \
+    AD_TYPE(K) sum = AD_CONSTANT(K, 0);                                      \
+    for (int i = 0; i < N - 1; i++) {                                        \
+      AD_TYPE(K) a = AD_SUB(K, AD_CONSTANT(K, 1), x[i]);                     \
+      AD_TYPE(K) b = AD_SUB(K, x[i + 1], AD_MUL(K, x[i], x[i]));             \
+      sum = AD_ADD(K, sum, AD_MUL(K, a, a));                                 \
+      sum = AD_ADD(K, sum, AD_MUL(K, AD_CONSTANT(K, 100), AD_MUL(K, b, b))); \
+    }                                                                        \
+    AD_TYPE(K) extra = AD_DIV(K, AD_SIN(K, x[0]), AD_EXP(K, x[1]));          \
+    extra = AD_ADD(K, extra, AD_LOG(K, AD_SQRT(K, AD_MUL(K, x[2], x[2]))));  \
+    extra = AD_SUB(K, extra, AD_POW(K, AD_COS(K, x[3]), 3));                 \
+    return AD_ADD(K, sum, AD_NEG(K, AD_NEG(K, extra)));                      \
+  }
+
+OBJECTIVE(Real)
+OBJECTIVE(Dual)
+OBJECTIVE(Var)
+
+// Analytic gradient of the objective
+static void objectiveGradient(const autodiff_real* x, autodiff_real* grad) {
+  for (int i = 0; i < N; i++) {
+    grad[i] = 0;
+  }
+  for (int i = 0; i < N - 1; i++) {
+    autodiff_real b = x[i + 1] - x[i] * x[i];
+    grad[i] += -2 * (1 - x[i]) - 400 * x[i] * b;
+    grad[i + 1] += 200 * b;
+  }
+  grad[0] += cos(x[0]) / exp(x[1]);
+  grad[1] -= sin(x[0]) / exp(x[1]);
+  grad[2] += 1 / x[2];
+  grad[3] += 3 * cos(x[3]) * cos(x[3]) * sin(x[3]);
+}
+
+// Sum of (x_i - x_{i+1})^2 + x_i^2 over many dimensions
+#define CHAIN(K)                                                 \
+  static AD_TYPE(K) chain##K(AD_TYPE(K) x[]) {                   \
+    AD_TYPE(K) sum = AD_MUL(K, x[LARGE_N - 1], x[LARGE_N - 1]);  \
+    for (int i = 0; i < LARGE_N - 1; i++) {                      \
+      AD_TYPE(K) d = AD_SUB(K, x[i], x[i + 1]);                  \
+      sum = AD_ADD(K, sum, AD_ADD(K, AD_MUL(K, d, d),            \
+                                  AD_MUL(K, x[i], x[i])));       \
+    }                                                            \
+    return sum;                                                  \
+  }
+
+CHAIN(Var)
+
+static int testExactGradients() {
+  autodiff_real point[N] = {0.3, -0.8, 1.7, 2.2};
+  autodiff_real expected[N];
+  autodiff_real grad[N];
+  autodiff_real value;
+  ADTapeNode nodes[100];
+  ADTape tape;
+  objectiveGradient(point, expected);
+
+  autodiff_real expectedValue = objectiveReal(point);
+  value = dualGradient(objectiveDual, point, grad, N);
+  if (isAlmostEqual(grad, expected, N, TOL) == 1 ||
+      isAlmostEqual(&value, &expectedValue, 1, TOL) == 1) {
+    return 1;
+  }
+
+  tapeInit(&tape, nodes, 100);
+  if (tapeGradient(objectiveVar, &tape, point, grad, N, &value) !=
+          AUTODIFF_SUCCESS ||
+      isAlmostEqual(grad, expected, N, TOL) == 1 ||
+      isAlmostEqual(&value, &expectedValue, 1, TOL) == 1) {
+    return 1;
+  }
+
+  // A small tape reports the capacity needed
+  int needed = tape.size;
+  tapeInit(&tape, nodes, needed - 1);
+  if (tapeGradient(objectiveVar, &tape, point, grad, N, NULL) !=
+          AUTODIFF_TAPE_OVERFLOW ||
+      tape.size != needed) {
+    printf("Fail: tape overflow not detected\n");
+    return 1;
+  }
+
+  // A far too small tape still reports the capacity needed, and a tape of
+  // that capacity is enough
+  tapeInit(&tape, nodes, 3);
+  if (tapeGradient(objectiveVar, &tape, point, grad, N, NULL) !=
+          AUTODIFF_TAPE_OVERFLOW ||
+      tape.size != needed) {
+    printf("Fail: tape of 3 nodes reports %d nodes instead of %d\n",
+           tape.size, needed);
+    return 1;
+  }
+  tapeInit(&tape, nodes, tape.size);
+  if (tapeGradient(objectiveVar, &tape, point, grad, N, NULL) !=
+          AUTODIFF_SUCCESS ||
+      isAlmostEqual(grad, expected, N, TOL) == 1) {
+    printf("Fail: tape of the reported size\n");
+    return 1;
+  }
+
+  printf("Success: %s(), %d operations recorded\n", __func__, needed);
+  return 0;
+}
+
+static int testLargeTape() {
+  static autodiff_real point[LARGE_N];
+  static autodiff_real grad[LARGE_N];
+  static ADTapeNode nodes[6 * LARGE_N];
+  ADTape tape;
+  for (int i = 0; i < LARGE_N; i++) {
+    point[i] = sin(i);
+  }
+
+  tapeInit(&tape, nodes, 6 * LARGE_N);
+  if (tapeGradient(chainVar, &tape, point, grad, LARGE_N, NULL) !=
+      AUTODIFF_SUCCESS) {
+    printf("Fail: tape of %d operations too small\n", tape.size);
+    return 1;
+  }
+  for (int i = 0; i < LARGE_N; i++) {
+    autodiff_real expected = 2 * point[i];
+    if (i > 0) {
+      expected -= 2 * (point[i - 1] - point[i]);
+    }
+    if (i < LARGE_N - 1) {
+      expected += 2 * (point[i] - point[i + 1]);
+    }
+    if (isAlmostEqual(&grad[i], &expected, 1, TOL) == 1) {
+      return 1;
+    }
+  }
+
+  printf("Success: %s()\n", __func__);
+  return 0;
+}
+
+#define QUADRATIC(K)                                                  \
+  static AD_TYPE(K) quadratic##K(AD_TYPE(K) x[]) {                    \
+    AD_TYPE(K) a = AD_SUB(K, x[0], AD_CONSTANT(K, 3.5));              \
+    AD_TYPE(K) b = AD_ADD(K, x[1], AD_CONSTANT(K, 4));                \
+    return AD_ADD(K, AD_MUL(K, a, a), AD_MUL(K, b, b));               \
+  }
+
+QUADRATIC(Real)
+QUADRATIC(Dual)
+
+// Exact gradient for gradient_descent
+static void quadraticGradient(gradient_real* x, gradient_real* grad) {
+  dualGradient(quadraticDual, x, grad, 2);
+}
+
+static int testGradientDescent() {
+  gradient_real point[2] = {3, 5};
+  gradient_real expected[2] = {3.5, -4.0};
+  gradient_real min;
+  int iterations = 10;
+
+  if (gradient_descent(quadraticReal, quadraticGradient, &min, point, 2, 2e-4,
+                       &iterations) != GRADIENT_SUCCESS ||
+      isAlmostEqual(point, expected, 2, 2e-4) == 1) {
+    printf("Fail: gradient descent with dual numbers\n");
+    return 1;
+  }
+
+  printf("Success: %s(), %d iterations\n", __func__, iterations);
+  return 0;
+}
+
+int main() {
+  int returnCode = 0;
+
+  returnCode |= testExactGradients();
+  returnCode |= testLargeTape();
+  returnCode |= testGradientDescent();
+
+  return returnCode;
+}
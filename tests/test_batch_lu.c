@@ -0,0 +1,84 @@
+#include "../src/batch_lu.h"
+#include <math.h>
+#include <stdio.h>
+
+#define BATCH_SIZE 37
+
+int testBatchLU(int size) {
+  batch_real matrices[size * size * BATCH_SIZE];
+  batch_real vectors[size * BATCH_SIZE];
+  batch_real expected[size * BATCH_SIZE];
+  int pivots[size * BATCH_SIZE];
+
+  for (int b = 0; b < BATCH_SIZE; b++) {
+    for (int i = 0; i < size; i++) {
+      for (int j = 0; j < size; j++) {
+        // Every other system has a null diagonal and needs pivoting
+        batch_real element = 1.0 / (1 + i + j + b);
+        if (i == j) {
+          element = b % 2 ? 0 : element + b;
+        } else if (j == (i + 1) % size) {
+          element += 2 + b;
+        }
+        matrices[(i * size + j) * BATCH_SIZE + b] = element;
+      }
+      expected[i * BATCH_SIZE + b] = i - b;
+    }
+    for (int i = 0; i < size; i++) {
+      batch_real sum = 0;
+      for (int j = 0; j < size; j++) {
+        sum += matrices[(i * size + j) * BATCH_SIZE + b] *
+               expected[j * BATCH_SIZE + b];
+      }
+      vectors[i * BATCH_SIZE + b] = sum;
+    }
+  }
+
+  if (batchLUFactorize(matrices, pivots, size, BATCH_SIZE) != BATCH_SUCCESS) {
+    printf("Error: a matrix of size %d is singular\n", size);
+    return 1;
+  }
+  batchLUSolve(matrices, pivots, size, BATCH_SIZE, vectors);
+
+  for (int i = 0; i < size * BATCH_SIZE; i++) {
+    if (fabs(vectors[i] - expected[i]) > 0.0001) {
+      printf("Error: size %d, %f != %f\n", size, vectors[i], expected[i]);
+      return 1;
+    }
+  }
+
+  printf("Success %s(%d)\n", __func__, size);
+  return 0;
+}
+
+int testBatchSingular() {
+  // The second system is singular, the first one must still be solved
+  batch_real matrices[] = {2, 1, 0, 2, 1, 1, 2, 2};
+  batch_real vectors[] = {3, 1, 3.5, 1};
+  int pivots[4];
+
+  if (batchLUFactorize(matrices, pivots, 2, 2) != BATCH_SINGULAR) {
+    printf("Error: singular matrix not detected\n");
+    return 1;
+  }
+  batchLUSolve(matrices, pivots, 2, 2, vectors);
+  if (fabs(vectors[0] - 1.5) > 0.0001 || fabs(vectors[2] - 1) > 0.0001) {
+    printf("Error: %f, %f != 1.5, 1\n", vectors[0], vectors[2]);
+    return 1;
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int main() {
+  int returnCode = 0;
+
+  // Sizes with a fixed kernel and sizes using the generic one
+  for (int size = 2; size <= BATCH_MAX_FIXED_SIZE + 1; size++) {
+    returnCode |= testBatchLU(size);
+  }
+  returnCode |= testBatchSingular();
+
+  return returnCode;
+}
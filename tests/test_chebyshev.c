@@ -0,0 +1,93 @@
+#include "../src/chebyshev.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_DEGREE 64
+
+chebyshev_real expSin(chebyshev_real x) { return exp(x) * sin(3 * x); }
+
+int testChebyshevBuild(chebyshev_function func, chebyshev_real a,
+                       chebyshev_real b, chebyshev_real tol) {
+  chebyshev_real coefficients[MAX_DEGREE + 1];
+  ChebyshevApproximation approximation;
+
+  if (chebyshevBuild(func, a, b, tol, MAX_DEGREE, coefficients,
+                     &approximation) != CHEBYSHEV_SUCCESS) {
+    printf("Error: approximation did not reach %e\n", tol);
+    return 1;
+  }
+
+  for (int i = 0; i <= 1000; i++) {
+    chebyshev_real x = a + (b - a) * i / 1000.0;
+    chebyshev_real error = fabs(chebyshevEvaluate(&approximation, x) - func(x));
+    if (error > tol) {
+      printf("Error: degree %d, error %e at x = %f\n", approximation.degree,
+             error, x);
+      return 1;
+    }
+  }
+
+  printf("Success %s() with degree %d for tolerance %g\n", __func__,
+         approximation.degree, tol);
+  return 0;
+}
+
+int testNotConverged() {
+  chebyshev_real coefficients[9];
+  ChebyshevApproximation approximation;
+
+  // |x| is not smooth, a degree 8 polynomial cannot reach the tolerance
+  if (chebyshevBuild(fabs, -1, 1, 1e-10, 8, coefficients, &approximation) !=
+          CHEBYSHEV_NOT_CONVERGED ||
+      approximation.degree != 8) {
+    printf("Error: non convergence not reported\n");
+    return 1;
+  }
+
+  if (chebyshevBuild(fabs, -1, 1, 1e-10, -1, coefficients, &approximation) !=
+      CHEBYSHEV_INVALID_DEGREE) {
+    printf("Error: negative degree not rejected\n");
+    return 1;
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int testPrintTable() {
+  chebyshev_real coefficients[MAX_DEGREE + 1];
+  ChebyshevApproximation approximation;
+  char buffer[4096];
+
+  chebyshevBuild(cos, 0, 1, 1e-6, MAX_DEGREE, coefficients, &approximation);
+  FILE* output = tmpfile();
+  chebyshevPrintTable(&approximation, "COS_TABLE", output);
+  rewind(output);
+  size_t length = fread(buffer, 1, sizeof(buffer) - 1, output);
+  buffer[length] = '\0';
+  fclose(output);
+
+  char expected[64];
+  sprintf(expected, "#define COS_TABLE_DEGREE %d\n", approximation.degree);
+  if (strncmp(buffer, expected, strlen(expected)) != 0 ||
+      strstr(buffer, "static const chebyshev_real COS_TABLE[") == NULL) {
+    printf("Error: unexpected table\n%s", buffer);
+    return 1;
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int main() {
+  int returnCode = 0;
+
+  returnCode |= testChebyshevBuild(exp, -1, 2, 1e-12);
+  returnCode |= testChebyshevBuild(expSin, -2, 1, 1e-8);
+  returnCode |= testChebyshevBuild(cos, 0, 10, 1e-3);
+  returnCode |= testNotConverged();
+  returnCode |= testPrintTable();
+
+  return returnCode;
+}
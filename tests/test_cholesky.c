@@ -0,0 +1,189 @@
+#include "../src/cholesky.h"
+#include "../src/matrix.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * @brief Build the symmetric positive definite matrix B^T * B + I
+ */
+void createSPDMatrix(cholesky_real* matrix, int size) {
+  cholesky_real base[size * size];
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      base[i * size + j] = sin(1.0 + i * size + j);
+    }
+  }
+  const matrix_size dims[3] = {size, size, size};
+  matrixMultiply(base, base, dims, matrix, 1);
+  for (int i = 0; i < size; i++) {
+    matrix[i * size + i] += 1;
+  }
+}
+
+/**
+ * @brief Fill matrix with A * X where X(i, j) = i - 2 * j
+ */
+void createRightHandSide(const cholesky_real* initialMatrix,
+                         cholesky_real* expectedX, cholesky_real* matrix,
+                         int size, int nbColumns) {
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < nbColumns; j++) {
+      expectedX[i * nbColumns + j] = i - 2 * j;
+    }
+  }
+  const matrix_size dims[3] = {size, size, nbColumns};
+  matrixMultiply(initialMatrix, expectedX, dims, matrix, 0);
+}
+
+int compareVectors(const cholesky_real* vector1,
+                   const cholesky_real* vector2, int length) {
+  for (int i = 0; i < length; i++) {
+    if (fabs(vector1[i] - vector2[i]) > 0.0001) {
+      printf("Error: %f != %f\n", vector1[i], vector2[i]);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int testCholeskySolve(int size, int nbColumns) {
+  cholesky_real initialMatrix[size * size];
+  cholesky_real lMatrix[size * size];
+  cholesky_real expectedX[size * nbColumns];
+  cholesky_real matrix[size * nbColumns];
+
+  createSPDMatrix(initialMatrix, size);
+  createRightHandSide(initialMatrix, expectedX, matrix, size, nbColumns);
+
+  memcpy(lMatrix, initialMatrix, size * size * sizeof(cholesky_real));
+  if (choleskyFactorize(lMatrix, size) != CHOLESKY_SUCCESS) {
+    printf("Error: matrix is not positive definite\n");
+    return 1;
+  }
+  choleskySolveMany(lMatrix, size, matrix, nbColumns);
+  if (compareVectors(matrix, expectedX, size * nbColumns)) {
+    return 1;
+  }
+
+  // A symmetric matrix with a negative eigenvalue must be rejected
+  cholesky_real indefinite[] = {1, 2, 2, 1};
+  if (choleskyFactorize(indefinite, 2) != CHOLESKY_NOT_POSITIVE_DEFINITE) {
+    printf("Error: indefinite matrix not detected\n");
+    return 1;
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int testLDLTSolve(int size, int nbColumns) {
+  cholesky_real initialMatrix[size * size];
+  cholesky_real ldlMatrix[size * size];
+  cholesky_real expectedX[size * nbColumns];
+  cholesky_real matrix[size * nbColumns];
+
+  // Symmetric indefinite matrix with a dominant diagonal of alternating signs
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      initialMatrix[i * size + j] = 1.0 / (1 + i + j);
+    }
+    initialMatrix[i * size + i] = i % 2 ? -size : size;
+  }
+  createRightHandSide(initialMatrix, expectedX, matrix, size, nbColumns);
+
+  memcpy(ldlMatrix, initialMatrix, size * size * sizeof(cholesky_real));
+  if (LDLTFactorize(ldlMatrix, size) != CHOLESKY_SUCCESS) {
+    printf("Error: matrix is singular\n");
+    return 1;
+  }
+  LDLTSolveMany(ldlMatrix, size, matrix, nbColumns);
+  if (compareVectors(matrix, expectedX, size * nbColumns)) {
+    return 1;
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int testRankOneUpdate(int size) {
+  cholesky_real initialMatrix[size * size];
+  cholesky_real updatedMatrix[size * size];
+  cholesky_real lMatrix[size * size];
+  cholesky_real ldlMatrix[size * size];
+  cholesky_real added[size];
+  cholesky_real removed[size];
+  cholesky_real vector[size];
+
+  // Sliding window: add a new observation and remove an old one
+  createSPDMatrix(initialMatrix, size);
+  for (int i = 0; i < size; i++) {
+    added[i] = cos(0.5 * i);
+    removed[i] = 0.1 * sin(0.7 * i);
+  }
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      updatedMatrix[i * size + j] = initialMatrix[i * size + j] +
+                                    added[i] * added[j] -
+                                    removed[i] * removed[j];
+    }
+  }
+
+  memcpy(lMatrix, initialMatrix, size * size * sizeof(cholesky_real));
+  memcpy(ldlMatrix, initialMatrix, size * size * sizeof(cholesky_real));
+  choleskyFactorize(lMatrix, size);
+  LDLTFactorize(ldlMatrix, size);
+
+  memcpy(vector, added, size * sizeof(cholesky_real));
+  choleskyUpdate(lMatrix, vector, size);
+  memcpy(vector, removed, size * sizeof(cholesky_real));
+  if (choleskyDowndate(lMatrix, vector, size) != CHOLESKY_SUCCESS) {
+    printf("Error: downdate failed\n");
+    return 1;
+  }
+  memcpy(vector, added, size * sizeof(cholesky_real));
+  LDLTRankOneUpdate(ldlMatrix, vector, size, 1);
+  memcpy(vector, removed, size * sizeof(cholesky_real));
+  if (LDLTRankOneUpdate(ldlMatrix, vector, size, -1) != CHOLESKY_SUCCESS) {
+    printf("Error: downdate failed\n");
+    return 1;
+  }
+
+  // The updated factors must solve the updated system
+  cholesky_real expectedX[size];
+  cholesky_real choleskyX[size];
+  cholesky_real ldltX[size];
+  createRightHandSide(updatedMatrix, expectedX, choleskyX, size, 1);
+  memcpy(ldltX, choleskyX, size * sizeof(cholesky_real));
+  choleskySolve(lMatrix, size, choleskyX);
+  LDLTSolve(ldlMatrix, size, ldltX);
+  if (compareVectors(choleskyX, expectedX, size) ||
+      compareVectors(ldltX, expectedX, size)) {
+    return 1;
+  }
+
+  // Removing more than what the matrix holds must fail
+  cholesky_real small[] = {1, 0, 0, 1};
+  cholesky_real tooLarge[] = {2, 0};
+  if (choleskyDowndate(small, tooLarge, 2) !=
+      CHOLESKY_NOT_POSITIVE_DEFINITE) {
+    printf("Error: invalid downdate not detected\n");
+    return 1;
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int main() {
+  int returnCode = 0;
+
+  returnCode |= testCholeskySolve(3, 1);
+  returnCode |= testLDLTSolve(3, 1);
+  // Larger than CHOLESKY_BLOCK_SIZE to go through several blocks
+  returnCode |= testCholeskySolve(2 * CHOLESKY_BLOCK_SIZE + 5, 3);
+  returnCode |= testLDLTSolve(2 * CHOLESKY_BLOCK_SIZE + 5, 3);
+  returnCode |= testRankOneUpdate(CHOLESKY_BLOCK_SIZE + 3);
+
+  return returnCode;
+}
@@ -1,4 +1,5 @@
 #include <finite_difference.h>
+#include <finite_difference_complex.h>
 #include <math.h>
 #include <stdio.h>
 
@@ -20,8 +21,20 @@ static int isAlmostEqual(const real* value, const real* expected, int n,
   return 0;
 }
 
+static int nbEvaluations = 0;
+
 // Function (x - 3.5)^2 + (y + 4)^2
-static real func(real* p) { return pow(p[0] - 3.5, 2) + pow(p[1] + 4, 2); }
+static real func(real* p) {
+  nbEvaluations++;
+  return pow(p[0] - 3.5, 2) + pow(p[1] + 4, 2);
+}
+
+// Batched version of func
+static void funcBatch(real* points, real* values, int count, int n) {
+  for (int k = 0; k < count; k++) {
+    values[k] = func(&points[k * n]);
+  }
+}
 
 // Gradient of (x - 3.5)^2 + (y + 4)^2
 static void dfunc(real* p, real* grad) {
@@ -29,6 +42,294 @@ static void dfunc(real* p, real* grad) {
   grad[1] = 2 * (p[1] + 4);
 }
 
+#define LARGE_N (FD_BATCH_SIZE + 5)
+
+// Function sum(i * x_i^2), batched
+static void largeBatch(real* points, real* values, int count, int n) {
+  for (int k = 0; k < count; k++) {
+    values[k] = 0;
+    for (int i = 0; i < n; i++) {
+      values[k] += i * points[k * n + i] * points[k * n + i];
+    }
+  }
+}
+
+// Function sum(i * x_i^2) of LARGE_N dimensions
+static real largeFunc(real* p) {
+  real value;
+  largeBatch(p, &value, 1, LARGE_N);
+  return value;
+}
+
+// More points than FD_BATCH_SIZE need several calls
+static int testLargeBatch() {
+  real point[LARGE_N];
+  real gradient[LARGE_N];
+  real approxGradient[LARGE_N];
+  for (int i = 0; i < LARGE_N; i++) {
+    point[i] = 1 - 0.1 * i;
+    gradient[i] = 2 * i * point[i];
+  }
+
+  gradientApproximationBatch(largeBatch, point, approxGradient, LARGE_N, EPS,
+                             Forward);
+  if (isAlmostEqual(gradient, approxGradient, LARGE_N, 1e-3) == 1) {
+    return 1;
+  }
+  gradientApproximationBatch(largeBatch, point, approxGradient, LARGE_N, EPS,
+                             Central);
+  if (isAlmostEqual(gradient, approxGradient, LARGE_N, CENTRAL_TOL) == 1) {
+    return 1;
+  }
+
+  // Enough dimensions to use threads when built with OpenMP
+  gradientApproximation(largeFunc, point, approxGradient, LARGE_N, EPS,
+                        Central);
+  return isAlmostEqual(gradient, approxGradient, LARGE_N, CENTRAL_TOL);
+}
+
+#define HUGE_N (2 * FD_BATCH_MAX_ELEMENTS)
+
+static int nbBatchCalls = 0;
+
+// Function sum((1 + i % 3) * x_i^2), batched
+static void hugeBatch(real* points, real* values, int count, int n) {
+  nbBatchCalls++;
+  for (int k = 0; k < count; k++) {
+    values[k] = 0;
+    for (int i = 0; i < n; i++) {
+      values[k] += (1 + i % 3) * points[k * n + i] * points[k * n + i];
+    }
+  }
+}
+
+// Points of more than FD_BATCH_MAX_ELEMENTS coordinates are given one by one
+static int testHugeBatch() {
+  real point[HUGE_N];
+  real gradient[HUGE_N];
+  real approxGradient[HUGE_N];
+  for (int i = 0; i < HUGE_N; i++) {
+    point[i] = sin(i);
+    gradient[i] = 2 * (1 + i % 3) * point[i];
+  }
+
+  nbBatchCalls = 0;
+  gradientApproximationBatch(hugeBatch, point, approxGradient, HUGE_N, EPS,
+                             Central);
+  if (nbBatchCalls != 2 * HUGE_N) {
+    printf("Fail: %d batched calls instead of %d\n", nbBatchCalls, 2 * HUGE_N);
+    return 1;
+  }
+  return isAlmostEqual(gradient, approxGradient, HUGE_N, 1e-4);
+}
+
+// Function exp(x) * sin(y) and its gradient
+static real smooth(real* p) { return exp(p[0]) * sin(p[1]); }
+
+static void dsmooth(real* p, real* grad) {
+  grad[0] = exp(p[0]) * sin(p[1]);
+  grad[1] = exp(p[0]) * cos(p[1]);
+}
+
+// Complex version of smooth for the complex-step method
+static complex_real complexSmooth(complex_real* p) {
+  return cexp(p[0]) * csin(p[1]);
+}
+
+// Extrapolated and complex-step gradients are more precise than central ones
+static int testHighAccuracy() {
+  real point[N] = {0.7, -1.3};
+  real gradient[N];
+  real approxGradient[N];
+  real error[N];
+  dsmooth(point, gradient);
+
+  gradientRichardson(smooth, point, approxGradient, N, 1e-1, 6, error);
+  printf("Using Richardson extrapolation\n");
+  if (isAlmostEqual(gradient, approxGradient, N, 1e-11) == 1) {
+    return 1;
+  }
+  for (int i = 0; i < N; i++) {
+    if (error[i] > 1e-8) {
+      printf("Fail: estimated error %g\n", error[i]);
+      return 1;
+    }
+  }
+
+  // Without any level, a single central difference is taken
+  real singleLevel[N];
+  gradientRichardson(smooth, point, singleLevel, N, 1e-1, 1, NULL);
+  gradientRichardson(smooth, point, approxGradient, N, 1e-1, 0, NULL);
+  if (isAlmostEqual(singleLevel, approxGradient, N, 0) == 1) {
+    return 1;
+  }
+
+  gradientComplexStep(complexSmooth, point, approxGradient, N, 1e-20);
+  printf("Using complex-step approximation\n");
+  if (isAlmostEqual(gradient, approxGradient, N, 1e-14) == 1) {
+    return 1;
+  }
+  return 0;
+}
+
+// Function (x^2 y, sin(x) + y^3, x y) from 2 to 3 dimensions
+static void vectorFunc(real* p, real* output) {
+  output[0] = p[0] * p[0] * p[1];
+  output[1] = sin(p[0]) + p[1] * p[1] * p[1];
+  output[2] = p[0] * p[1];
+}
+
+// Dense Jacobian and Hessian match the analytic ones
+static int testDenseMatrices() {
+  real point[N] = {0.7, -1.3};
+  real jacobian[3 * N];
+  real expected[3 * N] = {2 * point[0] * point[1], point[0] * point[0],
+                          cos(point[0]),           3 * point[1] * point[1],
+                          point[1],                point[0]};
+
+  jacobianApproximation(vectorFunc, point, jacobian, N, 3, EPS, Central);
+  if (isAlmostEqual(expected, jacobian, 3 * N, CENTRAL_TOL) == 1) {
+    return 1;
+  }
+  jacobianApproximation(vectorFunc, point, jacobian, N, 3, EPS, Forward);
+  if (isAlmostEqual(expected, jacobian, 3 * N, TOL) == 1) {
+    return 1;
+  }
+
+  // Hessian of exp(x) * sin(y)
+  real hessian[N * N];
+  real e = exp(point[0]);
+  real expectedHessian[N * N] = {e * sin(point[1]), e * cos(point[1]),
+                                 e * cos(point[1]), -e * sin(point[1])};
+  hessianApproximation(smooth, point, hessian, N, 1e-4);
+  if (isAlmostEqual(expectedHessian, hessian, N * N, CENTRAL_TOL) == 1) {
+    return 1;
+  }
+
+  printf("Using dense Jacobian and Hessian approximations\n");
+  return 0;
+}
+
+#define SPARSE_N 10000
+#define BANDWIDTH 2
+
+static int nbVectorEvaluations = 0;
+
+// Banded function: output i is x_i^3 + sum over |j - i| <= 2, j != i of
+// (i + 1) * x_i * x_j / (j + 1)
+static void bandedFunc(real* p, real* output) {
+  nbVectorEvaluations++;
+  for (int i = 0; i < SPARSE_N; i++) {
+    output[i] = p[i] * p[i] * p[i];
+    for (int j = i - BANDWIDTH; j <= i + BANDWIDTH; j++) {
+      if (j != i && j >= 0 && j < SPARSE_N) {
+        output[i] += (i + 1) * p[i] * p[j] / (j + 1);
+      }
+    }
+  }
+}
+
+// Gradient of sum(x_i^4 / 4 + (x_i - x_{i+1})^2), whose Hessian is tridiagonal
+static void chainGradient(real* p, real* grad) {
+  for (int i = 0; i < SPARSE_N; i++) {
+    grad[i] = p[i] * p[i] * p[i];
+    if (i > 0) {
+      grad[i] += 2 * (p[i] - p[i - 1]);
+    }
+    if (i < SPARSE_N - 1) {
+      grad[i] += 2 * (p[i] - p[i + 1]);
+    }
+  }
+}
+
+static int rowStart[SPARSE_N + 1];
+static int columns[SPARSE_N * (2 * BANDWIDTH + 1)];
+static int colors[SPARSE_N];
+static real values[SPARSE_N * (2 * BANDWIDTH + 1)];
+
+// Builds the pattern of a band matrix with sorted columns
+static void bandPattern(SparsityPattern* pattern, int bandwidth) {
+  int k = 0;
+  for (int i = 0; i < SPARSE_N; i++) {
+    rowStart[i] = k;
+    for (int j = i - bandwidth; j <= i + bandwidth; j++) {
+      if (j >= 0 && j < SPARSE_N) {
+        columns[k++] = j;
+      }
+    }
+  }
+  rowStart[SPARSE_N] = k;
+  pattern->nbRows = SPARSE_N;
+  pattern->nbColumns = SPARSE_N;
+  pattern->rowStart = rowStart;
+  pattern->columns = columns;
+}
+
+// Colored band matrices need a few evaluations whatever their size
+static int testSparseMatrices() {
+  static real point[SPARSE_N];
+  SparsityPattern pattern;
+  for (int i = 0; i < SPARSE_N; i++) {
+    point[i] = 1 + 0.5 * sin(i);
+  }
+
+  bandPattern(&pattern, BANDWIDTH);
+  int nbColors = colorColumns(&pattern, colors);
+  if (nbColors != 2 * BANDWIDTH + 1) {
+    printf("Fail: %d colors instead of %d\n", nbColors, 2 * BANDWIDTH + 1);
+    return 1;
+  }
+
+  nbVectorEvaluations = 0;
+  sparseJacobianApproximation(bandedFunc, point, &pattern, colors, nbColors,
+                              values, EPS, Central);
+  if (nbVectorEvaluations != 2 * nbColors) {
+    printf("Fail: %d evaluations\n", nbVectorEvaluations);
+    return 1;
+  }
+  for (int i = 0; i < SPARSE_N; i++) {
+    for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+      int j = columns[k];
+      real expected = 0;
+      if (j == i) {
+        expected = 3 * point[i] * point[i];
+        for (int l = i - BANDWIDTH; l <= i + BANDWIDTH; l++) {
+          if (l != i && l >= 0 && l < SPARSE_N) {
+            expected += (i + 1) * point[l] / (l + 1);
+          }
+        }
+      } else {
+        expected = (i + 1) * point[i] / (j + 1);
+      }
+      if (isAlmostEqual(&expected, &values[k], 1, 1e-5) == 1) {
+        return 1;
+      }
+    }
+  }
+
+  bandPattern(&pattern, 1);
+  nbColors = colorColumns(&pattern, colors);
+  sparseHessianApproximation(chainGradient, point, &pattern, colors, nbColors,
+                             values, EPS);
+  for (int i = 0; i < SPARSE_N; i++) {
+    for (int k = rowStart[i]; k < rowStart[i + 1]; k++) {
+      int j = columns[k];
+      real expected = -2;
+      if (j == i) {
+        expected = 3 * point[i] * point[i] + (i > 0 ? 2 : 0) +
+                   (i < SPARSE_N - 1 ? 2 : 0);
+      }
+      if (isAlmostEqual(&expected, &values[k], 1, 1e-5) == 1) {
+        return 1;
+      }
+    }
+  }
+
+  printf("Using sparse Jacobian and Hessian approximations, %d colors\n",
+         nbColors);
+  return 0;
+}
+
 int main() {
   real point[N] = {3, 5};
   real approxGradient[N];
@@ -40,6 +341,7 @@ int main() {
   printf("The gradient of the function is : X = %f Y = %f\n", gradient[0],
          gradient[1]);
 
+  nbEvaluations = 0;
   gradientApproximation(func, point, approxGradient, N, EPS, Forward);
   printf("Using Foward approximation\n");
   printf("The approximate gradient of the function is : X = %f Y = %f\n",
@@ -49,6 +351,12 @@ int main() {
     return 1;
   }
 
+  // The base point is evaluated only once
+  if (nbEvaluations != N + 1) {
+    printf("Fail: %d evaluations instead of %d\n", nbEvaluations, N + 1);
+    return 1;
+  }
+
   gradientApproximation(func, point, approxGradient, N, EPS, Backward);
   printf("Using Backward approximation\n");
   printf("The approximate gradient of the function is : X = %f Y = %f\n",
@@ -68,6 +376,30 @@ int main() {
     return 1;
   }
 
+  // Batched evaluations give the same gradients
+  const approximationType types[] = {Forward, Backward, Central};
+  for (int t = 0; t < 3; t++) {
+    real batchGradient[N];
+    gradientApproximation(func, point, approxGradient, N, EPS, types[t]);
+    nbEvaluations = 0;
+    gradientApproximationBatch(funcBatch, point, batchGradient, N, EPS,
+                               types[t]);
+    if (isAlmostEqual(approxGradient, batchGradient, N, 1e-12) == 1 ||
+        nbEvaluations != (types[t] == Central ? 2 * N : N + 1)) {
+      printf("Fail: batched approximation, %d evaluations\n", nbEvaluations);
+      return 1;
+    }
+  }
+  if (testLargeBatch() == 1 || testHugeBatch() == 1) {
+    return 1;
+  }
+  printf("Using batched approximation\n");
+
+  if (testHighAccuracy() == 1 || testDenseMatrices() == 1 ||
+      testSparseMatrices() == 1) {
+    return 1;
+  }
+
   printf("Success\n");
   return 0;
 }
@@ -9,6 +9,36 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+/* Solve a system which needs row exchanges with the allocation-free routine */
+int test_gauss_elimination_solve(void) {
+  int i;
+  /* The first pivot is zero, the system must be reordered */
+  gauss_real augmented[] = {0., 2., 1., -1., 1., 1., 0., -1.,
+                            3., 1., 2., 7.};
+  const gauss_real expectedResults[] = {1., -2., 3.};
+  gauss_real x[3];
+
+  if (gauss_elimination_solve(3, augmented, x) != GAUSS_SUCCESS) {
+    printf("Error! gauss_elimination_solve reported a singular system \n");
+    return 1;
+  }
+  for (i = 0; i < 3; i++) {
+    if (fabs(x[i] - expectedResults[i]) > 1e-12) {
+      printf("Error! , %0.3f expected to be equal to %0.3f \n", x[i],
+             expectedResults[i]);
+      return 1;
+    }
+  }
+
+  gauss_real singular[] = {1., 2., 3., 2., 4., 6.};
+  if (gauss_elimination_solve(2, singular, x) != GAUSS_SINGULAR) {
+    printf("Error! singular system not detected \n");
+    return 1;
+  }
+  printf("Success : gauss elimination solve test \n");
+  return 0;
+}
+
 int main(void) {
   /* Variables and pointers declarations */
   int i;
@@ -50,11 +80,13 @@ int main(void) {
     if (sol[i] != expectedResults[i]) {
       printf("Error! , %0.3f expected to be equal to %0.3f \n", sol[i],
              expectedResults[i]);
+      free(sol);
       return 1;
     }
   }
+  free(sol);
   printf("Success : gauss elimination test \n");
-  return 0;
+  return test_gauss_elimination_solve();
 }
 
 /* -- End of file -- */
@@ -31,6 +31,131 @@ static void dfunc(gradient_real* p, gradient_real* grad) {
   grad[1] = 2 * (p[1] + 4);
 }
 
+#define LARGE_N 100
+#define HISTORY 7
+
+static int nbEvaluations = 0;
+
+// Extended Rosenbrock function, minimum at (1, ..., 1)
+static gradient_real rosenbrock(gradient_real* p) {
+  gradient_real sum = 0.0;
+  nbEvaluations++;
+  for (int i = 0; i < LARGE_N; i += 2) {
+    sum += pow(1 - p[i], 2) + 100 * pow(p[i + 1] - p[i] * p[i], 2);
+  }
+  return sum;
+}
+
+// Gradient of the extended Rosenbrock function
+static void rosenbrockGradient(gradient_real* p, gradient_real* grad) {
+  for (int i = 0; i < LARGE_N; i += 2) {
+    gradient_real b = p[i + 1] - p[i] * p[i];
+    grad[i] = -2 * (1 - p[i]) - 400 * p[i] * b;
+    grad[i + 1] = 200 * b;
+  }
+}
+
+// L-BFGS reaches the minimum with fewer evaluations than conjugate gradient
+static int testLBFGS() {
+  gradient_real min = 0.0;
+  gradient_real point[N] = {3, 5};
+  gradient_real expected[N] = {3.5, -4.0};
+  int iterations = ITMAX;
+
+  if (lbfgs(func, dfunc, &min, point, N, HISTORY, TOL, &iterations) ==
+          GRADIENT_ERROR ||
+      isAlmostEqual(point, expected, N, TOL) == 1) {
+    printf("Fail: L-BFGS on (x - 3.5)^2 + (y + 4)^2\n");
+    return 1;
+  }
+
+  gradient_real largePoint[LARGE_N];
+  gradient_real ones[LARGE_N];
+  for (int i = 0; i < LARGE_N; i++) {
+    largePoint[i] = i % 2 ? 1.0 : -1.2;
+    ones[i] = 1.0;
+  }
+  iterations = 1000;
+  nbEvaluations = 0;
+  if (lbfgs(rosenbrock, rosenbrockGradient, &min, largePoint, LARGE_N,
+            HISTORY, 1e-12, &iterations) == GRADIENT_ERROR ||
+      isAlmostEqual(largePoint, ones, LARGE_N, 1e-3) == 1) {
+    printf("Fail: L-BFGS on the Rosenbrock function\n");
+    return 1;
+  }
+  int lbfgsEvaluations = nbEvaluations;
+
+  for (int i = 0; i < LARGE_N; i++) {
+    largePoint[i] = i % 2 ? 1.0 : -1.2;
+  }
+  iterations = 1000;
+  nbEvaluations = 0;
+  gradient_descent(rosenbrock, rosenbrockGradient, &min, largePoint, LARGE_N,
+                   1e-12, &iterations);
+
+  printf("Rosenbrock: %d evaluations with L-BFGS, %d with conjugate "
+         "gradient\n",
+         lbfgsEvaluations, nbEvaluations);
+  if (lbfgsEvaluations >= nbEvaluations) {
+    return 1;
+  }
+  return 0;
+}
+
+#define SCALED_N 50
+#define SCALE 1e-4
+
+// Badly conditioned quadratic whose minimum is close to 0
+static gradient_real scaledQuadratic(gradient_real* p) {
+  gradient_real sum = 0.0;
+  for (int i = 0; i < SCALED_N; i++) {
+    gradient_real diff = p[i] - SCALE * (1 + i % 5);
+    sum += (1 + i * i) * diff * diff;
+  }
+  return sum;
+}
+
+// Gradient of the badly conditioned quadratic
+static void scaledQuadraticGradient(gradient_real* p, gradient_real* grad) {
+  for (int i = 0; i < SCALED_N; i++) {
+    grad[i] = 2 * (1 + i * i) * (p[i] - SCALE * (1 + i % 5));
+  }
+}
+
+// The corrections must be kept whatever the scale of the problem
+static int testLBFGSScaled() {
+  gradient_real min = 0.0;
+  gradient_real point[SCALED_N] = {0.0};
+  int iterations = 2000;
+
+  if (lbfgs(scaledQuadratic, scaledQuadraticGradient, &min, point, SCALED_N,
+            HISTORY, 1e-12, &iterations) == GRADIENT_ERROR) {
+    printf("Fail: L-BFGS on a scaled quadratic\n");
+    return 1;
+  }
+  gradient_real error = 0.0;
+  gradient_real norm = 0.0;
+  for (int i = 0; i < SCALED_N; i++) {
+    gradient_real expected = SCALE * (1 + i % 5);
+    error += (point[i] - expected) * (point[i] - expected);
+    norm += expected * expected;
+  }
+  if (sqrt(error / norm) > 1e-5 || iterations > 1000) {
+    printf("Fail: L-BFGS on a scaled quadratic, relative error %e after %d "
+           "iterations\n",
+           sqrt(error / norm), iterations);
+    return 1;
+  }
+
+  iterations = ITMAX;
+  if (lbfgs(func, dfunc, &min, point, N, 0, TOL, &iterations) !=
+      GRADIENT_ERROR) {
+    printf("Fail: L-BFGS accepted an empty history\n");
+    return 1;
+  }
+  return 0;
+}
+
 int main() {
   gradient_real min = 0.0;
   gradient_real point[N] = {3, 5};
@@ -53,6 +178,10 @@ int main() {
     return 1;
   }
 
+  if (testLBFGS() == 1 || testLBFGSScaled() == 1) {
+    return 1;
+  }
+
   printf("Success\n");
   return 0;
 }
@@ -63,6 +63,190 @@ int testJacobi(real_number* input, real_number* expectedEigenValues,
   return 0;
 }
 
+int testJacobiParallel(real_number* input, vec_size size, vec_size sweeps,
+                       real_number epsilon) {
+
+  vec_size squaredSize = size * size;
+
+  real_number mat1[squaredSize];
+  memcpy(mat1, input, sizeof(real_number) * squaredSize);
+
+  real_number output[squaredSize];
+
+  jacobiParallel(mat1, size, output, sweeps);
+
+  // Every column of the output must be an eigenvector of the input associated
+  // with the eigenvalue found on the diagonal
+  for (vec_size col = 0; col < size; ++col) {
+    real_number eigenValue = mat1[col * size + col];
+    for (vec_size row = 0; row < size; ++row) {
+      real_number product = 0.0;
+      for (vec_size k = 0; k < size; ++k) {
+        product += input[row * size + k] * output[k * size + col];
+      }
+      real_number diff = fabs(product - eigenValue * output[row * size + col]);
+      if (diff > epsilon) {
+        printf("Fail : Test parallel jacobi with size = %d. Column %d is not "
+               "an eigenvector of eigenvalue %f (difference is %f, but must be "
+               "less than %f)\n",
+               size, col, eigenValue, diff, epsilon);
+        return 1;
+      }
+    }
+  }
+
+  printf("Success : Test parallel jacobi method with size = %d\n", size);
+
+  return 0;
+}
+
+int testJacobiSVD(real_number* input, vec_size rows, vec_size cols,
+                  vec_size nbSingular, real_number epsilon) {
+
+  real_number mat1[rows * cols];
+  memcpy(mat1, input, sizeof(real_number) * rows * cols);
+
+  real_number singularValues[nbSingular];
+  real_number uMatrix[rows * nbSingular];
+  real_number vMatrix[cols * cols];
+
+  jacobiSVD(mat1, rows, cols, nbSingular, singularValues, uMatrix, vMatrix, 20);
+
+  for (vec_size i = 0; i < nbSingular; ++i) {
+    if (i > 0 && singularValues[i] > singularValues[i - 1]) {
+      printf("Fail : Test jacobi SVD. Singular values are not sorted\n");
+      return 1;
+    }
+
+    // A * v = sigma * u
+    for (vec_size row = 0; row < rows; ++row) {
+      real_number product = 0.0;
+      for (vec_size k = 0; k < cols; ++k) {
+        product += input[row * cols + k] * vMatrix[k * cols + i];
+      }
+      real_number diff =
+          fabs(product - singularValues[i] * uMatrix[row * nbSingular + i]);
+      if (diff > epsilon) {
+        printf("Fail : Test jacobi SVD. Singular vectors %d are invalid "
+               "(difference is %f, but must be less than %f)\n",
+               i, diff, epsilon);
+        return 1;
+      }
+    }
+
+    // Right singular vectors are orthonormal
+    for (vec_size j = 0; j < nbSingular; ++j) {
+      real_number dot = 0.0;
+      for (vec_size k = 0; k < cols; ++k) {
+        dot += vMatrix[k * cols + i] * vMatrix[k * cols + j];
+      }
+      if (fabs(dot - (i == j ? 1.0 : 0.0)) > epsilon) {
+        printf("Fail : Test jacobi SVD. Right singular vectors %d and %d are "
+               "not orthonormal\n",
+               i, j);
+        return 1;
+      }
+    }
+  }
+
+  printf("Success : Test jacobi SVD with %d singular values\n", nbSingular);
+
+  return 0;
+}
+
+int testJacobiSVDScale(vec_size rows, vec_size cols, real_number scale) {
+
+  real_number mat1[rows * cols];
+  for (vec_size row = 0; row < rows; ++row) {
+    for (vec_size col = 0; col < cols; ++col) {
+      mat1[row * cols + col] =
+          scale * (sin(1.0 + row * cols + col) + (row == col ? 2.0 : 0.0));
+    }
+  }
+
+  real_number singularValues[cols];
+  real_number uMatrix[rows * cols];
+
+  jacobiSVD(mat1, rows, cols, cols, singularValues, uMatrix, NULL, -1);
+
+  // The convergence test is relative, so the left singular vectors must be
+  // orthonormal whatever the scale of the matrix
+  for (vec_size i = 0; i < cols; ++i) {
+    for (vec_size j = 0; j <= i; ++j) {
+      real_number dot = 0.0;
+      for (vec_size row = 0; row < rows; ++row) {
+        dot += uMatrix[row * cols + i] * uMatrix[row * cols + j];
+      }
+      real_number diff = fabs(dot - (i == j ? 1.0 : 0.0));
+      if (diff > 1e-10) {
+        printf("Fail : Test jacobi SVD with scale = %g. Left singular vectors "
+               "%d and %d are not orthonormal (difference is %g)\n",
+               scale, i, j, diff);
+        return 1;
+      }
+    }
+  }
+
+  printf("Success : Test jacobi SVD with scale = %g\n", scale);
+
+  return 0;
+}
+
+int testJacobiPacked(real_number* input, vec_size size,
+                     real_number* expectedEigenValues, real_number epsilon) {
+
+  vec_size packedSize = size * (size + 1) / 2;
+  real_number packed[packedSize];
+  real_number packedValuesOnly[packedSize];
+  vec_size index = 0;
+  for (vec_size row = 0; row < size; ++row) {
+    for (vec_size col = row; col < size; ++col) {
+      packed[index] = input[row * size + col];
+      packedValuesOnly[index] = input[row * size + col];
+      ++index;
+    }
+  }
+
+  real_number eigenValues[size];
+  real_number eigenValuesOnly[size];
+  real_number eigenVectors[size * size];
+
+  jacobiPacked(packed, size, eigenValues, eigenVectors, 10);
+  jacobiPacked(packedValuesOnly, size, eigenValuesOnly, NULL, 10);
+
+  for (vec_size col = 0; col < size; ++col) {
+    // Eigenvalues can be found in any order
+    vec_size found = 0;
+    for (vec_size i = 0; i < size; ++i) {
+      found |= fabs(eigenValues[col] - expectedEigenValues[i]) < epsilon;
+    }
+    if (!found || fabs(eigenValues[col] - eigenValuesOnly[col]) > epsilon) {
+      printf("Fail : Test packed jacobi. Eigenvalue %f is invalid\n",
+             eigenValues[col]);
+      return 1;
+    }
+
+    for (vec_size row = 0; row < size; ++row) {
+      real_number product = 0.0;
+      for (vec_size k = 0; k < size; ++k) {
+        product += input[row * size + k] * eigenVectors[k * size + col];
+      }
+      real_number diff =
+          fabs(product - eigenValues[col] * eigenVectors[row * size + col]);
+      if (diff > epsilon) {
+        printf("Fail : Test packed jacobi. Column %d is not an eigenvector "
+               "(difference is %f, but must be less than %f)\n",
+               col, diff, epsilon);
+        return 1;
+      }
+    }
+  }
+
+  printf("Success : Test packed jacobi method\n");
+
+  return 0;
+}
+
 int main() {
 
   //////////////////////////////////////////////////
@@ -100,5 +284,37 @@ int main() {
   fail |= testJacobi(matTestJacobi, expectedEigenValues, expectedEigenVectors,
                      3, 10, 0, EPSILON_CMP);
 
+  //////////////////////////////////////////////////
+  // Test Parallel Jacobi
+  //////////////////////////////////////////////////
+
+  real_number matTestJacobiParallel[16] = {4.0, 1.0, 2.0, 0.5, 1.0, 3.0,
+                                           0.0, 1.0, 2.0, 0.0, 5.0, 1.0,
+                                           0.5, 1.0, 1.0, 2.0};
+
+  fail |= testJacobiParallel(matTestJacobi, 3, 10, EPSILON);
+  fail |= testJacobiParallel(matTestJacobiParallel, 4, 10, EPSILON);
+
+  //////////////////////////////////////////////////
+  // Test Jacobi SVD
+  //////////////////////////////////////////////////
+
+  real_number matTestJacobiSVD[12] = {1.0, 2.0, 0.0, 2.0, 0.0, 1.0,
+                                      0.0, 1.0, 3.0, 1.0, 1.0, 1.0};
+
+  fail |= testJacobiSVD(matTestJacobiSVD, 4, 3, 3, EPSILON);
+  fail |= testJacobiSVD(matTestJacobiSVD, 4, 3, 2, EPSILON);
+  fail |= testJacobiSVDScale(20, 10, 1.0);
+  fail |= testJacobiSVDScale(20, 10, 1e-2);
+  fail |= testJacobiSVDScale(40, 30, 1e-3);
+
+  //////////////////////////////////////////////////
+  // Test Packed Jacobi
+  //////////////////////////////////////////////////
+
+  real_number packedEigenValues[3] = {4.372281, -1.372281, 0.0};
+
+  fail |= testJacobiPacked(matTestJacobi, 3, packedEigenValues, EPSILON);
+
   return fail;
 }
@@ -0,0 +1,219 @@
+#include "../src/krylov.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define SIZE 1000
+#define MAX_ITERATIONS 2000
+
+/**
+ * @brief Fill a CSR tridiagonal matrix with -1 - convection, 2 and
+ * -1 + convection on its three diagonals. It is symmetric positive definite
+ * when convection is 0
+ */
+void createTridiagonal(int* rowStart, int* columns, krylov_real* values,
+                       krylov_real convection, CSRMatrix* matrix) {
+  int index = 0;
+  for (int i = 0; i < SIZE; i++) {
+    rowStart[i] = index;
+    if (i > 0) {
+      columns[index] = i - 1;
+      values[index++] = -1 - convection;
+    }
+    columns[index] = i;
+    values[index++] = 2 + (krylov_real)i / SIZE;
+    if (i < SIZE - 1) {
+      columns[index] = i + 1;
+      values[index++] = -1 + convection;
+    }
+  }
+  rowStart[SIZE] = index;
+  matrix->nbRows = SIZE;
+  matrix->rowStart = rowStart;
+  matrix->columns = columns;
+  matrix->values = values;
+}
+
+/**
+ * @brief Check that x is the solution of A * x = b, with b = A * ones
+ */
+int checkSolution(int returnCode, const krylov_real* x, int iterations,
+                  const char* name) {
+  if (returnCode != KRYLOV_SUCCESS) {
+    printf("Error: %s did not converge, code %d\n", name, returnCode);
+    return 1;
+  }
+  for (int i = 0; i < SIZE; i++) {
+    if (fabs(x[i] - 1) > 0.0001) {
+      printf("Error: %s, %f != 1\n", name, x[i]);
+      return 1;
+    }
+  }
+  printf("Success %s in %d iterations\n", name, iterations);
+  return 0;
+}
+
+/**
+ * @brief Matrix free Laplacian with the same values as createTridiagonal
+ */
+void laplacian(const krylov_real* input, krylov_real* output, void* data) {
+  (void)data;
+  for (int i = 0; i < SIZE; i++) {
+    output[i] = (2 + (krylov_real)i / SIZE) * input[i];
+    if (i > 0) {
+      output[i] -= input[i - 1];
+    }
+    if (i < SIZE - 1) {
+      output[i] -= input[i + 1];
+    }
+  }
+}
+
+int testConjugateGradient() {
+  int rowStart[SIZE + 1];
+  int columns[3 * SIZE];
+  krylov_real values[3 * SIZE];
+  CSRMatrix matrix;
+  createTridiagonal(rowStart, columns, values, 0, &matrix);
+
+  krylov_real ones[SIZE];
+  krylov_real b[SIZE];
+  krylov_real x[SIZE];
+  krylov_real work[KRYLOV_CG_WORK_SIZE(SIZE)];
+  for (int i = 0; i < SIZE; i++) {
+    ones[i] = 1;
+  }
+  CSRMatrixVector(ones, b, &matrix);
+
+  int returnCode = 0;
+  int code;
+  int iterations = MAX_ITERATIONS;
+  memset(x, 0, sizeof(x));
+  code = conjugateGradient(laplacian, NULL, NULL, NULL, b, x, SIZE, 1e-10,
+                           &iterations, work);
+  returnCode |= checkSolution(code, x, iterations, "matrix free CG");
+
+  krylov_real inverseDiagonal[SIZE];
+  JacobiPreconditioner jacobi = {0, inverseDiagonal};
+  jacobiPreconditionerInit(&matrix, &jacobi);
+  iterations = MAX_ITERATIONS;
+  memset(x, 0, sizeof(x));
+  code = conjugateGradient(CSRMatrixVector, &matrix, jacobiPreconditionerApply,
+                           &jacobi, b, x, SIZE, 1e-10, &iterations, work);
+  returnCode |= checkSolution(code, x, iterations, "Jacobi CG");
+
+  // ILU(0) of a tridiagonal matrix is exact, a single iteration is enough
+  krylov_real iluValues[3 * SIZE];
+  int diagonal[SIZE];
+  ILU0Preconditioner ilu = {NULL, iluValues, diagonal};
+  if (ILU0PreconditionerInit(&matrix, &ilu) != KRYLOV_SUCCESS) {
+    printf("Error: ILU(0) failed\n");
+    return 1;
+  }
+  iterations = MAX_ITERATIONS;
+  memset(x, 0, sizeof(x));
+  code = conjugateGradient(CSRMatrixVector, &matrix, ILU0PreconditionerApply,
+                           &ilu, b, x, SIZE, 1e-10, &iterations, work);
+  returnCode |= checkSolution(code, x, iterations, "ILU(0) CG");
+  if (iterations > 1) {
+    printf("Error: ILU(0) CG took %d iterations\n", iterations);
+    return 1;
+  }
+
+  return returnCode;
+}
+
+int testNonSymmetricSolvers() {
+  int rowStart[SIZE + 1];
+  int columns[3 * SIZE];
+  krylov_real values[3 * SIZE];
+  CSRMatrix matrix;
+  createTridiagonal(rowStart, columns, values, 0.5, &matrix);
+
+  krylov_real ones[SIZE];
+  krylov_real b[SIZE];
+  krylov_real x[SIZE];
+  for (int i = 0; i < SIZE; i++) {
+    ones[i] = 1;
+  }
+  CSRMatrixVector(ones, b, &matrix);
+
+  krylov_real inverseDiagonal[SIZE];
+  JacobiPreconditioner jacobi = {0, inverseDiagonal};
+  jacobiPreconditionerInit(&matrix, &jacobi);
+
+  int returnCode = 0;
+  int code;
+  int iterations = MAX_ITERATIONS;
+  krylov_real work[KRYLOV_GMRES_WORK_SIZE(SIZE, 30)];
+  memset(x, 0, sizeof(x));
+  code = biCGSTAB(CSRMatrixVector, &matrix, jacobiPreconditionerApply, &jacobi,
+                  b, x, SIZE, 1e-10, &iterations, work);
+  returnCode |= checkSolution(code, x, iterations, "Jacobi BiCGSTAB");
+
+  iterations = MAX_ITERATIONS;
+  memset(x, 0, sizeof(x));
+  code = GMRES(CSRMatrixVector, &matrix, jacobiPreconditionerApply, &jacobi, b,
+               x, SIZE, 30, 1e-10, &iterations, work);
+  returnCode |= checkSolution(code, x, iterations, "Jacobi GMRES(30)");
+
+  krylov_real iluValues[3 * SIZE];
+  int diagonal[SIZE];
+  ILU0Preconditioner ilu = {NULL, iluValues, diagonal};
+  ILU0PreconditionerInit(&matrix, &ilu);
+  iterations = MAX_ITERATIONS;
+  memset(x, 0, sizeof(x));
+  code = GMRES(CSRMatrixVector, &matrix, ILU0PreconditionerApply, &ilu, b, x,
+               SIZE, 30, 1e-10, &iterations, work);
+  returnCode |= checkSolution(code, x, iterations, "ILU(0) GMRES(30)");
+
+  // Too few iterations must be reported
+  iterations = 3;
+  memset(x, 0, sizeof(x));
+  if (GMRES(CSRMatrixVector, &matrix, NULL, NULL, b, x, SIZE, 30, 1e-10,
+            &iterations, work) != KRYLOV_NOT_CONVERGED) {
+    printf("Error: GMRES should not have converged\n");
+    return 1;
+  }
+
+  return returnCode;
+}
+
+/**
+ * @brief Null matrix, whose Krylov space does not grow
+ */
+void nullMatrix(const krylov_real* input, krylov_real* output, void* data) {
+  (void)input;
+  (void)data;
+  output[0] = 0;
+  output[1] = 0;
+}
+
+int testGMRESBreakdown() {
+  // The first Hessenberg column is null, so no rotation can be formed
+  krylov_real b[2] = {1, 1};
+  krylov_real x[2] = {0, 0};
+  krylov_real work[KRYLOV_GMRES_WORK_SIZE(2, 5)];
+  int iterations = 10;
+
+  int code = GMRES(nullMatrix, NULL, NULL, NULL, b, x, 2, 5, 1e-10,
+                   &iterations, work);
+  if (code != KRYLOV_BREAKDOWN || x[0] != 0 || x[1] != 0) {
+    printf("Error: GMRES breakdown returned %d, x = (%f, %f)\n", code, x[0],
+           x[1]);
+    return 1;
+  }
+
+  printf("Success: GMRES breakdown detected\n");
+  return 0;
+}
+
+int main() {
+  int returnCode = 0;
+
+  returnCode |= testConjugateGradient();
+  returnCode |= testNonSymmetricSolvers();
+  returnCode |= testGMRESBreakdown();
+
+  return returnCode;
+}
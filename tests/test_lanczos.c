@@ -1,5 +1,7 @@
 #include "matrix.h"
+#include <float.h>
 #include <lanczos.h>
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -70,6 +72,192 @@ int testLanczos(double* initialMatrix, double* tMatrix, double* vMatrix,
   return 0;
 }
 
+/**
+ * Validates that the columns of V are orthonormal and that
+ * transpose(V) * A * V is equal to T
+ */
+static int validateLanczosBasis(double* matrix, int dim, int nbVectors,
+                                double* tMatrix, double* vMatrix) {
+  for (int p = 0; p < nbVectors; ++p) {
+    for (int q = 0; q < nbVectors; ++q) {
+      double dot = p == q ? -1.0 : 0.0;
+      double projection = -tMatrix[p * nbVectors + q];
+      for (int i = 0; i < dim; ++i) {
+        dot += vMatrix[i * nbVectors + p] * vMatrix[i * nbVectors + q];
+        for (int j = 0; j < dim; ++j) {
+          projection += vMatrix[i * nbVectors + p] * matrix[i * dim + j] *
+                        vMatrix[j * nbVectors + q];
+        }
+      }
+      if (isAlmostZero(&dot) != 0 || isAlmostZero(&projection) != 0) {
+        printf("Fail : %s(), Lanczos vectors %d and %d are invalid\n",
+               __func__, p, q);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+int testLanczosTopEigen() {
+#define topDim 8
+#define topEigen 2
+#define topKrylov 4
+  // Tridiagonal matrix with 2 on the diagonal and -1 next to it. Its eigen
+  // values are 2 - 2cos(k * pi / (topDim + 1)) for k = 1..topDim
+  double matrix[topDim][topDim] = {{0.0}};
+  for (int i = 0; i < topDim; ++i) {
+    matrix[i][i] = 2.0;
+    if (i + 1 < topDim) {
+      matrix[i][i + 1] = -1.0;
+      matrix[i + 1][i] = -1.0;
+    }
+  }
+  double initialVector[topDim] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0};
+  double eigenValues[topEigen];
+  double eigenVectors[topDim][topEigen];
+  int restarts = 100;
+
+  int status =
+      lanczosTopEigen(matrix[0], topDim, topEigen, topKrylov, initialVector,
+                      1e-8, &restarts, eigenValues, eigenVectors[0]);
+  if (status != LANCZOS_SUCCESS) {
+    printf("Fail : %s(), did not converge after %d restarts\n", __func__,
+           restarts);
+    return 1;
+  }
+
+  for (int k = 0; k < topEigen; ++k) {
+    double expected =
+        2.0 - 2.0 * cos((topDim - k) * acos(-1.0) / (topDim + 1));
+    double diff = eigenValues[k] - expected;
+    if (isAlmostZero(&diff) != 0) {
+      printf("Fail : %s(), expected eigen value %f but got %f\n", __func__,
+             expected, eigenValues[k]);
+      return 1;
+    }
+
+    // Validate that A * v = lambda * v
+    for (int i = 0; i < topDim; ++i) {
+      double product = 0.0;
+      for (int j = 0; j < topDim; ++j) {
+        product += matrix[i][j] * eigenVectors[j][k];
+      }
+      diff = product - eigenValues[k] * eigenVectors[i][k];
+      if (isAlmostZero(&diff) != 0) {
+        printf("Fail : %s(), eigen vector %d is invalid\n", __func__, k);
+        return 1;
+      }
+    }
+  }
+
+  printf("Success : %s()\n", __func__);
+  return 0;
+}
+
+int testPartialReorthogonalization() {
+#define partialDim 150
+#define partialIter 80
+  // A few well separated eigen values and a cluster of close ones. The Ritz
+  // values of the separated eigen values converge quickly, which is when the
+  // Lanczos vectors lose their orthogonality
+  double matrix[partialDim][partialDim] = {{0.0}};
+  double initialVector[partialDim];
+  for (int i = 0; i < partialDim; ++i) {
+    matrix[i][i] = i < 5 ? 100.0 - 10.0 * i : 1.0 + 0.001 * i;
+    initialVector[i] = 1.0 + i % 7;
+  }
+  double tMatrix[partialIter][partialIter] = {{0.0}};
+  double vMatrix[partialDim][partialIter];
+
+  uint_least8_t fullCount;
+  lanczosWithReorthogonalization(matrix[0], partialDim, partialIter,
+                                 initialVector, tMatrix[0], vMatrix[0],
+                                 FullReorthogonalization, &fullCount);
+
+  uint_least8_t partialCount;
+  lanczosWithReorthogonalization(matrix[0], partialDim, partialIter,
+                                 initialVector, tMatrix[0], vMatrix[0],
+                                 PartialReorthogonalization, &partialCount);
+
+  if (partialCount == 0 || partialCount >= fullCount) {
+    printf("Fail : %s(), %d reorthogonalizations instead of %d\n", __func__,
+           partialCount, fullCount);
+    return 1;
+  }
+
+  // The vectors must stay orthogonal to the square root of the machine
+  // precision
+  for (int p = 0; p < partialIter; ++p) {
+    for (int q = 0; q < p; ++q) {
+      double dot = 0.0;
+      for (int i = 0; i < partialDim; ++i) {
+        dot += vMatrix[i][p] * vMatrix[i][q];
+      }
+      if (fabs(dot) > sqrt(DBL_EPSILON)) {
+        printf("Fail : %s(), dot product of vectors %d and %d is %e\n",
+               __func__, p, q, dot);
+        return 1;
+      }
+    }
+  }
+
+  if (validateLanczosBasis(matrix[0], partialDim, partialIter, tMatrix[0],
+                           vMatrix[0]) != 0) {
+    return 1;
+  }
+
+  printf("Success : %s()\n", __func__);
+  return 0;
+}
+
+int testBlockLanczos() {
+#define blockDim 6
+#define blockSize 2
+#define nbBlocks 2
+  // The eigen value 5 has a multiplicity of 2
+  double matrix[blockDim][blockDim] = {
+      {5.0, 0.0, 0.0, 0.0, 0.0, 0.0}, {0.0, 5.0, 0.0, 0.0, 0.0, 0.0},
+      {0.0, 0.0, 3.0, 1.0, 0.0, 0.0}, {0.0, 0.0, 1.0, 3.0, 0.0, 0.0},
+      {0.0, 0.0, 0.0, 0.0, 1.0, 0.5}, {0.0, 0.0, 0.0, 0.0, 0.5, 1.0}};
+  // The initial block lies in the invariant subspace of the first four
+  // coordinates, which is fully spanned after two blocks
+  double initialBlock[blockDim][blockSize] = {{1.0, 0.0}, {0.0, 1.0},
+                                              {1.0, 1.0}, {2.0, 0.0},
+                                              {0.0, 0.0}, {0.0, 0.0}};
+  double tMatrix[blockSize * nbBlocks][blockSize * nbBlocks];
+  double vMatrix[blockDim][blockSize * nbBlocks];
+
+  blockLanczos(matrix[0], blockDim, blockSize, nbBlocks, initialBlock[0],
+               tMatrix[0], vMatrix[0]);
+
+  if (validateLanczosBasis(matrix[0], blockDim, blockSize * nbBlocks,
+                           tMatrix[0], vMatrix[0]) != 0) {
+    return 1;
+  }
+
+  // The vector (1, 1, 0, 0, 0, 0) belongs to the eigen space of 5, which a
+  // single starting vector cannot span. It must be reproduced by
+  // V * transpose(V)
+  double vector[blockDim] = {1.0, 1.0, 0.0, 0.0, 0.0, 0.0};
+  for (int i = 0; i < blockDim; ++i) {
+    double projection = -vector[i];
+    for (int p = 0; p < blockSize * nbBlocks; ++p) {
+      for (int j = 0; j < blockDim; ++j) {
+        projection += vMatrix[i][p] * vMatrix[j][p] * vector[j];
+      }
+    }
+    if (isAlmostZero(&projection) != 0) {
+      printf("Fail : %s(), eigen vector is not in the Krylov subspace\n",
+             __func__);
+      return 1;
+    }
+  }
+
+  printf("Success : %s()\n", __func__);
+  return 0;
+}
+
 int main() {
   double initialMatrix[size][size] = {
       {1.0, 1.0, 1.0}, {1.0, 1.0, 1.0}, {1.0, 1.0, 1.0}};
@@ -78,6 +266,10 @@ int main() {
   double initialVector[size] = {1.0, 2.0, 3.0};
   const double expectedEigenValue = 3.0;
 
-  return testLanczos(initialMatrix[0], tMatrix[0], vMatrix[0], initialVector,
-                     expectedEigenValue);
+  int fail = testLanczos(initialMatrix[0], tMatrix[0], vMatrix[0],
+                         initialVector, expectedEigenValue);
+  fail |= testLanczosTopEigen();
+  fail |= testPartialReorthogonalization();
+  fail |= testBlockLanczos();
+  return fail;
 }
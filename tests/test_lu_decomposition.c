@@ -1,6 +1,7 @@
 #include "lu_decomposition.h"
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 int compareMatrix(float* matrix1, float* matrix2, int size) {
@@ -31,6 +32,205 @@ int testLUDecomposition(float* initialMatrix, float* expectedL,
   return returnCode;
 }
 
+int testLUSolve(lu_real* initialMatrix, lu_real* expectedX, int size) {
+  lu_real luMatrix[size * size];
+  int pivots[size];
+  lu_real vector[size];
+  memcpy(luMatrix, initialMatrix, size * size * sizeof(lu_real));
+
+  // Build b = A * x
+  for (int i = 0; i < size; i++) {
+    vector[i] = 0;
+    for (int j = 0; j < size; j++) {
+      vector[i] += initialMatrix[i * size + j] * expectedX[j];
+    }
+  }
+
+  if (LUFactorize(luMatrix, pivots, size) != LU_SUCCESS) {
+    printf("Error: matrix is singular\n");
+    return 1;
+  }
+  LUSolve(luMatrix, pivots, size, vector);
+
+  for (int i = 0; i < size; i++) {
+    if (fabs(vector[i] - expectedX[i]) > 0.0001) {
+      printf("Error: %f != %f\n", vector[i], expectedX[i]);
+      return 1;
+    }
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int testLUSolveMany(int size, int nbColumns) {
+  lu_real initialMatrix[size * size];
+  lu_real luMatrix[size * size];
+  int pivots[size];
+  lu_real expectedX[size * nbColumns];
+  lu_real matrix[size * nbColumns];
+
+  // Matrix with a null diagonal, which requires pivoting
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      initialMatrix[i * size + j] = i == j ? 0 : 1.0 / (1 + i + 2 * j);
+    }
+    initialMatrix[i * size + (i + 1) % size] += size;
+    for (int j = 0; j < nbColumns; j++) {
+      expectedX[i * nbColumns + j] = i - 2 * j;
+    }
+  }
+
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < nbColumns; j++) {
+      matrix[i * nbColumns + j] = 0;
+      for (int k = 0; k < size; k++) {
+        matrix[i * nbColumns + j] +=
+            initialMatrix[i * size + k] * expectedX[k * nbColumns + j];
+      }
+    }
+  }
+
+  memcpy(luMatrix, initialMatrix, size * size * sizeof(lu_real));
+  if (LUFactorize(luMatrix, pivots, size) != LU_SUCCESS) {
+    printf("Error: matrix is singular\n");
+    return 1;
+  }
+  LUSolveMany(luMatrix, pivots, size, matrix, nbColumns);
+
+  for (int i = 0; i < size * nbColumns; i++) {
+    if (fabs(matrix[i] - expectedX[i]) > 0.0001) {
+      printf("Error: %f != %f\n", matrix[i], expectedX[i]);
+      return 1;
+    }
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int testLUSingular(int size) {
+  lu_real matrix[size * size];
+  int pivots[size];
+
+  // The last column is null, which is only found at the last step
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      matrix[i * size + j] = j == size - 1 ? 0 : 1.0 / (1 + i + j);
+    }
+    matrix[i * size + i % (size - 1)] += 2;
+  }
+
+  if (LUFactorize(matrix, pivots, size) != LU_SINGULAR) {
+    printf("Error: singular matrix not detected\n");
+    return 1;
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int testLUSolveMixedPrecision(int size) {
+  // On the heap, like the copies made by the solver, for large sizes
+  lu_real* matrix = (lu_real*)malloc((size_t)size * size * sizeof(lu_real));
+  lu_real expectedX[size];
+  lu_real vector[size];
+  lu_real solution[size];
+
+  // Well conditioned matrix: the single precision factorization is enough
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      matrix[i * size + j] = (i == j ? size : 0) + 1.0 / (1 + i + 2 * j);
+    }
+    expectedX[i] = 1.0 / 3 + i;
+  }
+  for (int i = 0; i < size; i++) {
+    vector[i] = 0;
+    for (int j = 0; j < size; j++) {
+      vector[i] += matrix[i * size + j] * expectedX[j];
+    }
+  }
+
+  int iterations = 10;
+  if (LUSolveMixedPrecision(matrix, size, vector, solution, 1e-15,
+                            &iterations) != LU_SUCCESS) {
+    printf("Error: mixed precision refinement did not converge\n");
+    free(matrix);
+    return 1;
+  }
+  for (int i = 0; i < size; i++) {
+    // Far beyond the accuracy of a single precision solve
+    if (fabs(solution[i] - expectedX[i]) > 1e-12 * fabs(expectedX[i])) {
+      printf("Error: %.15f != %.15f\n", solution[i], expectedX[i]);
+      free(matrix);
+      return 1;
+    }
+  }
+  if (iterations < 1 || iterations > 4) {
+    printf("Error: %d refinement iterations\n", iterations);
+    free(matrix);
+    return 1;
+  }
+
+  // Hilbert matrix: too ill-conditioned for single precision
+  const int hilbertSize = 10;
+  for (int i = 0; i < hilbertSize; i++) {
+    for (int j = 0; j < hilbertSize; j++) {
+      matrix[i * hilbertSize + j] = 1.0 / (1 + i + j);
+    }
+    vector[i] = 1;
+  }
+  iterations = 10;
+  if (LUSolveMixedPrecision(matrix, hilbertSize, vector, solution, 1e-15,
+                            &iterations) != LU_DOUBLE_FALLBACK) {
+    printf("Error: ill-conditioned matrix not detected\n");
+    free(matrix);
+    return 1;
+  }
+  for (int i = 0; i < hilbertSize; i++) {
+    lu_real sum = 0;
+    for (int j = 0; j < hilbertSize; j++) {
+      sum += matrix[i * hilbertSize + j] * solution[j];
+    }
+    if (fabs(sum - 1) > 1e-6) {
+      printf("Error: residual %e\n", sum - 1);
+      free(matrix);
+      return 1;
+    }
+  }
+
+  free(matrix);
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int testLUSolveMixedPrecisionOverflow() {
+  // Entries beyond the range of float
+  lu_real matrix[] = {1e39, 2e38, 3e38, 1e39};
+  lu_real expectedX[] = {1, -2};
+  lu_real vector[2];
+  lu_real solution[2];
+  for (int i = 0; i < 2; i++) {
+    vector[i] = matrix[2 * i] * expectedX[0] + matrix[2 * i + 1] * expectedX[1];
+  }
+
+  int iterations = 10;
+  if (LUSolveMixedPrecision(matrix, 2, vector, solution, 1e-15,
+                            &iterations) != LU_DOUBLE_FALLBACK) {
+    printf("Error: float overflow not detected\n");
+    return 1;
+  }
+  for (int i = 0; i < 2; i++) {
+    if (!(fabs(solution[i] - expectedX[i]) < 1e-12)) {
+      printf("Error: %f != %f\n", solution[i], expectedX[i]);
+      return 1;
+    }
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
 int main() {
   const int size = 4;
   float initialMatrix[] = {2, 3,  5,  5,  6, 13, 5,  19,
@@ -40,5 +240,21 @@ int main() {
   float expectedU[] = {2, 3, 5,  5, 0, 4, -10, 4,
                        0, 0, 45, 2, 0, 0, 0,   16.511111};
 
-  return testLUDecomposition(initialMatrix, expectedL, expectedU, size);
+  int returnCode =
+      testLUDecomposition(initialMatrix, expectedL, expectedU, size);
+
+  lu_real pivotMatrix[] = {0, 2, 1, 1, 1, 0, 3, 1, 2};
+  lu_real expectedX[] = {1, -2, 3};
+  returnCode |= testLUSolve(pivotMatrix, expectedX, 3);
+
+  // Larger than LU_BLOCK_SIZE to go through several blocks
+  returnCode |= testLUSolveMany(2 * LU_BLOCK_SIZE + 5, 3);
+  returnCode |= testLUSolveMany(LU_PARALLEL_MIN_SIZE + 7, LU_BLOCK_SIZE + 3);
+  returnCode |= testLUSingular(LU_PARALLEL_MIN_SIZE + 7);
+  returnCode |= testLUSolveMixedPrecision(50);
+  // Far too large for copies of the matrix on the stack
+  returnCode |= testLUSolveMixedPrecision(1000);
+  returnCode |= testLUSolveMixedPrecisionOverflow();
+
+  return returnCode;
 }
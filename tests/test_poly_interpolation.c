@@ -24,6 +24,78 @@ int test_poly(poly_real x_a[], poly_real y_a[], unsigned int n, poly_real x,
   return isSuccessful;
 }
 
+int test_interpolant(poly_real x_a[], poly_real y_a[], unsigned int n) {
+  poly_interpolant interpolant;
+  poly_real weights[n];
+  poly_real x[2 * n + 3];
+  poly_real y_batch[2 * n + 3];
+  poly_real y, error;
+  unsigned int count = 0;
+
+  if (poly_interpolant_build(&interpolant, x_a, y_a, n, weights) != 0) {
+    printf("Fail: interpolant build\n");
+    return 1;
+  }
+
+  /* Measured points, points in between and extrapolated points. */
+  x[count++] = x_a[0] - 1.;
+  for (unsigned int i = 0; i < n; i++) {
+    x[count++] = x_a[i];
+    if (i + 1 < n) {
+      x[count++] = 0.3 * x_a[i] + 0.7 * x_a[i + 1];
+    }
+  }
+  x[count++] = x_a[n - 1] + 2.;
+  poly_interpolant_eval_batch(&interpolant, x, y_batch, count);
+
+  for (unsigned int i = 0; i < count; i++) {
+    poly_interpolation(x_a, y_a, n, x[i], &y, &error);
+    poly_real y_eval = poly_interpolant_eval(&interpolant, x[i]);
+    if (fabs(y_eval - y) > 1e-9 || fabs(y_batch[i] - y) > 1e-9) {
+      printf("Fail: x = %0.3f, y = %0.6f, eval = %0.6f, batch = %0.6f\n",
+             x[i], y, y_eval, y_batch[i]);
+      return 1;
+    }
+  }
+
+  printf("Success: interpolant matches Neville on %u points\n", count);
+  return 0;
+}
+
+/* Chebyshev points spread over [a, b]: the plain products of the differences
+ * would overflow or underflow. */
+int test_interpolant_scaling(poly_real a, poly_real b, unsigned int n) {
+  poly_real x_a[n];
+  poly_real y_a[n];
+  poly_real weights[n];
+  poly_interpolant interpolant;
+  const poly_real pi = acos(-1.);
+
+  for (unsigned int i = 0; i < n; i++) {
+    poly_real t = cos((2. * i + 1.) * pi / (2. * n));
+    x_a[i] = a + (b - a) * (t + 1.) / 2.;
+    y_a[i] = sin(3. * t);
+  }
+  if (poly_interpolant_build(&interpolant, x_a, y_a, n, weights) != 0) {
+    printf("Fail: interpolant build\n");
+    return 1;
+  }
+
+  for (unsigned int i = 0; i < 10; i++) {
+    poly_real t = -1. + 0.2 * i + 0.01;
+    poly_real x = a + (b - a) * (t + 1.) / 2.;
+    poly_real y = poly_interpolant_eval(&interpolant, x);
+    if (!(fabs(y - sin(3. * t)) < 1e-9)) {
+      printf("Fail: %u points on [%g, %g], y = %f instead of %f\n", n, a, b, y,
+             sin(3. * t));
+      return 1;
+    }
+  }
+
+  printf("Success: interpolant on %u points over [%g, %g]\n", n, a, b);
+  return 0;
+}
+
 int main(void) {
   /* Define measured data. */
   poly_real x_a[] = {2., 4., 6.};
@@ -51,6 +123,21 @@ int main(void) {
   isSuccessful |= test_poly(x_a2, y_a2, 5, -3., -4.024);
   isSuccessful |= test_poly(x_a2, y_a2, 5, 12., -1.082);
 
+  /* Build once and evaluate many times. */
+  isSuccessful |= test_interpolant(x_a, y_a, 3);
+  isSuccessful |= test_interpolant(x_a2, y_a2, 5);
+  isSuccessful |= test_interpolant_scaling(-1., 1., 1500);
+  isSuccessful |= test_interpolant_scaling(0., 1e5, 200);
+
+  /* Duplicated x values cannot be interpolated. */
+  poly_real x_a3[] = {1., 2., 2.};
+  poly_real weights[3];
+  poly_interpolant interpolant;
+  if (poly_interpolant_build(&interpolant, x_a3, y_a, 3, weights) != -1) {
+    printf("Fail: duplicated x values not detected\n");
+    isSuccessful = 1;
+  }
+
   return isSuccessful;
 }
 
@@ -0,0 +1,122 @@
+#include "../src/matrix.h"
+#include "../src/qr_decomposition.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+int testLeastSquaresExact(int nbRows, int nbColumns, int nbRhs) {
+  qr_real matrix[nbRows * nbColumns];
+  qr_real expectedX[nbColumns * nbRhs];
+  qr_real rhs[nbRows * nbRhs];
+
+  for (int i = 0; i < nbRows; i++) {
+    for (int j = 0; j < nbColumns; j++) {
+      matrix[i * nbColumns + j] = (i == j ? 2 : 0) + 1.0 / (1 + i + j);
+    }
+  }
+  for (int i = 0; i < nbColumns; i++) {
+    for (int j = 0; j < nbRhs; j++) {
+      expectedX[i * nbRhs + j] = i - 2 * j;
+    }
+  }
+  // The system is consistent, the least-squares solution is exact
+  const matrix_size dims[3] = {nbRows, nbColumns, nbRhs};
+  matrixMultiply(matrix, expectedX, dims, rhs, 0);
+
+  if (leastSquares(matrix, nbRows, nbColumns, rhs, nbRhs) != QR_SUCCESS) {
+    printf("Error: least squares failed\n");
+    return 1;
+  }
+  for (int i = 0; i < nbColumns * nbRhs; i++) {
+    if (fabs(rhs[i] - expectedX[i]) > 0.0001) {
+      printf("Error: %f != %f\n", rhs[i], expectedX[i]);
+      return 1;
+    }
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int testLeastSquaresFit() {
+  // Fit y = a + b * x + c * x^2 on noisy points
+  const int nbPoints = 50;
+  const int nbColumns = 3;
+  qr_real matrix[nbPoints * nbColumns];
+  qr_real initialMatrix[nbPoints * nbColumns];
+  qr_real rhs[nbPoints];
+  qr_real residual[nbPoints];
+
+  for (int i = 0; i < nbPoints; i++) {
+    qr_real x = i / 10.0;
+    matrix[i * nbColumns] = 1;
+    matrix[i * nbColumns + 1] = x;
+    matrix[i * nbColumns + 2] = x * x;
+    rhs[i] = 2 - 3 * x + 0.5 * x * x + 0.01 * sin(7.0 * i);
+  }
+  memcpy(initialMatrix, matrix, sizeof(matrix));
+  memcpy(residual, rhs, sizeof(rhs));
+
+  if (leastSquares(matrix, nbPoints, nbColumns, rhs, 1) != QR_SUCCESS) {
+    printf("Error: least squares failed\n");
+    return 1;
+  }
+
+  const qr_real expected[] = {2, -3, 0.5};
+  for (int i = 0; i < nbColumns; i++) {
+    if (fabs(rhs[i] - expected[i]) > 0.01) {
+      printf("Error: %f != %f\n", rhs[i], expected[i]);
+      return 1;
+    }
+  }
+
+  // The residual must be orthogonal to the columns of A
+  qr_real fitted[nbPoints];
+  qr_real normal[nbColumns];
+  const matrix_size dims[3] = {nbPoints, nbColumns, 1};
+  matrixMultiply(initialMatrix, rhs, dims, fitted, 0);
+  vectorSubstract(residual, fitted, nbPoints);
+  for (int i = 0; i < nbColumns; i++) {
+    normal[i] = 0;
+    for (int k = 0; k < nbPoints; k++) {
+      normal[i] += initialMatrix[k * nbColumns + i] * residual[k];
+    }
+    if (fabs(normal[i]) > 1e-9) {
+      printf("Error: residual is not orthogonal, %e\n", normal[i]);
+      return 1;
+    }
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int testRankDeficient() {
+  // The second column is twice the first one
+  qr_real matrix[] = {1, 2, 0, 2, 4, 1, 3, 6, 0, 4, 8, 1};
+  qr_real rhs[] = {1, 2, 3, 4};
+  if (leastSquares(matrix, 4, 3, rhs, 1) != QR_RANK_DEFICIENT) {
+    printf("Error: rank deficiency not detected\n");
+    return 1;
+  }
+  if (leastSquares(matrix, 2, 3, rhs, 1) != QR_INVALID_SIZE) {
+    printf("Error: invalid size not detected\n");
+    return 1;
+  }
+
+  printf("Success %s()\n", __func__);
+  return 0;
+}
+
+int main() {
+  int returnCode = 0;
+
+  returnCode |= testLeastSquaresExact(4, 3, 1);
+  // Larger than QR_BLOCK_SIZE to go through several blocks
+  returnCode |= testLeastSquaresExact(3 * QR_BLOCK_SIZE, 2 * QR_BLOCK_SIZE + 5,
+                                      QR_BLOCK_SIZE + 2);
+  returnCode |= testLeastSquaresFit();
+  returnCode |= testRankDeficient();
+
+  return returnCode;
+}
@@ -0,0 +1,125 @@
+/* This file is part of the 1chipML library. */
+#include "../src/spline_interpolation.h"
+#include <stdio.h>
+
+#define NB_POINTS 20
+
+static spline_real cubic(spline_real x) {
+  return 0.5 * x * x * x - 2. * x * x + x - 3.;
+}
+
+static spline_real cubic_derivative(spline_real x) {
+  return 1.5 * x * x - 4. * x + 1.;
+}
+
+/* A clamped spline with exact end slopes reproduces a cubic exactly and a
+   natural spline reproduces a line exactly. */
+int test_exact_reproduction(void) {
+  spline_real x_a[NB_POINTS], y_a[NB_POINTS], line[NB_POINTS];
+  spline_real slopes[NB_POINTS], line_slopes[NB_POINTS];
+  spline clamped, natural;
+
+  for (int i = 0; i < NB_POINTS; i++) {
+    /* Uneven spacing */
+    x_a[i] = -2. + 0.3 * i + 0.01 * i * i;
+    y_a[i] = cubic(x_a[i]);
+    line[i] = 2. * x_a[i] - 1.;
+  }
+  if (spline_build(&clamped, x_a, y_a, NB_POINTS, ClampedSpline,
+                   cubic_derivative(x_a[0]),
+                   cubic_derivative(x_a[NB_POINTS - 1]), slopes) != 0 ||
+      spline_build(&natural, x_a, line, NB_POINTS, NaturalSpline, 0., 0.,
+                   line_slopes) != 0) {
+    printf("Fail: spline build\n");
+    return 1;
+  }
+
+  for (spline_real x = -2.5; x < 6.; x += 0.37) {
+    if (fabs(spline_eval(&clamped, x) - cubic(x)) > 1e-9 ||
+        fabs(spline_eval(&natural, x) - (2. * x - 1.)) > 1e-9) {
+      printf("Fail: x = %0.3f, clamped = %0.6f, cubic = %0.6f\n", x,
+             spline_eval(&clamped, x), cubic(x));
+      return 1;
+    }
+  }
+
+  printf("Success: splines reproduce polynomials\n");
+  return 0;
+}
+
+/* A monotone spline must not overshoot a step in the data. */
+int test_monotone(void) {
+  spline_real x_a[] = {0., 1., 2., 3., 4., 5., 6.};
+  spline_real y_a[] = {0., 0., 0., 1., 1., 1., 1.};
+  spline_real slopes[7];
+  spline curve;
+
+  if (spline_build(&curve, x_a, y_a, 7, MonotoneSpline, 0., 0., slopes) != 0) {
+    printf("Fail: monotone spline build\n");
+    return 1;
+  }
+
+  spline_real previous = 0.;
+  for (spline_real x = 0.; x <= 6.; x += 0.05) {
+    spline_real y = spline_eval(&curve, x);
+    if (y < previous - 1e-12 || y < 0. || y > 1.) {
+      printf("Fail: overshoot at x = %0.3f, y = %0.6f\n", x, y);
+      return 1;
+    }
+    previous = y;
+  }
+
+  printf("Success: monotone spline does not overshoot\n");
+  return 0;
+}
+
+/* The streaming evaluator must match the binary search evaluation. */
+int test_stream(void) {
+  spline_real x_a[NB_POINTS], y_a[NB_POINTS], slopes[NB_POINTS];
+  spline curve;
+  spline_stream stream;
+
+  for (int i = 0; i < NB_POINTS; i++) {
+    x_a[i] = i * i * 0.1;
+    y_a[i] = sin(x_a[i]);
+  }
+  spline_build(&curve, x_a, y_a, NB_POINTS, NaturalSpline, 0., 0., slopes);
+  spline_stream_init(&stream, &curve);
+
+  /* Increasing queries with small and large steps, then a jump back. */
+  spline_real queries[] = {-1., 0., 0.05, 0.1, 0.35, 0.4, 3.,  3.1,
+                           20., 36., 40., 1.,  1.2,  0.,  36.1};
+  for (unsigned int i = 0; i < sizeof(queries) / sizeof(queries[0]); i++) {
+    spline_real expected = spline_eval(&curve, queries[i]);
+    spline_real y = spline_stream_eval(&stream, queries[i]);
+    if (y != expected ||
+        stream.segment != spline_find_segment(&curve, queries[i])) {
+      printf("Fail: x = %0.3f, stream = %0.6f, expected = %0.6f\n",
+             queries[i], y, expected);
+      return 1;
+    }
+  }
+
+  /* Unsorted data cannot be interpolated. */
+  spline_real unsorted[] = {0., 2., 1.};
+  if (spline_build(&curve, unsorted, y_a, 3, NaturalSpline, 0., 0., slopes) !=
+      -1) {
+    printf("Fail: unsorted data not detected\n");
+    return 1;
+  }
+
+  printf("Success: streaming evaluator matches binary search\n");
+  return 0;
+}
+
+int main(void) {
+  int isSuccessful = 0;
+
+  isSuccessful |= test_exact_reproduction();
+  isSuccessful |= test_monotone();
+  isSuccessful |= test_stream();
+
+  return isSuccessful;
+}
+
+/* -- End of file -- */
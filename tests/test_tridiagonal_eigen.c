@@ -0,0 +1,84 @@
+#include "tridiagonal_eigen.h"
+#include <math.h>
+#include <stdio.h>
+
+#define SIZE 8
+#define EPSILON_CMP 0.000001
+
+int testTridiagonalEigen(tridiagonal_real* alpha, tridiagonal_real* beta,
+                         tridiagonal_real* expectedEigenValues, int size) {
+  tridiagonal_real eigenValues[size];
+  tridiagonal_real valuesOnly[size];
+  tridiagonal_real eigenVectors[size * size];
+  for (int i = 0; i < size; ++i) {
+    eigenValues[i] = alpha[i];
+    valuesOnly[i] = alpha[i];
+  }
+
+  if (tridiagonalEigen(eigenValues, beta, size, eigenVectors) !=
+          TRIDIAGONAL_SUCCESS ||
+      tridiagonalEigen(valuesOnly, beta, size, NULL) != TRIDIAGONAL_SUCCESS) {
+    printf("Fail : %s(), eigen values did not converge\n", __func__);
+    return 1;
+  }
+
+  for (int k = 0; k < size; ++k) {
+    if (fabs(eigenValues[k] - expectedEigenValues[k]) > EPSILON_CMP ||
+        fabs(valuesOnly[k] - expectedEigenValues[k]) > EPSILON_CMP) {
+      printf("Fail : %s(), eigen value %d should be %f, but is %f\n", __func__,
+             k, expectedEigenValues[k], eigenValues[k]);
+      return 1;
+    }
+
+    // Validate that T * v = lambda * v
+    for (int i = 0; i < size; ++i) {
+      tridiagonal_real product = alpha[i] * eigenVectors[i * size + k];
+      if (i > 0) {
+        product += beta[i - 1] * eigenVectors[(i - 1) * size + k];
+      }
+      if (i < size - 1) {
+        product += beta[i] * eigenVectors[(i + 1) * size + k];
+      }
+      tridiagonal_real diff =
+          product - eigenValues[k] * eigenVectors[i * size + k];
+      if (fabs(diff) > EPSILON_CMP) {
+        printf("Fail : %s(), eigen vector %d is invalid\n", __func__, k);
+        return 1;
+      }
+    }
+  }
+
+  printf("Success : %s()\n", __func__);
+  return 0;
+}
+
+int main() {
+  // Matrix with 2 on the diagonal and -1 next to it. Its eigen values are
+  // 2 - 2cos(k * pi / (SIZE + 1)) for k = 1..SIZE
+  tridiagonal_real alpha[SIZE];
+  tridiagonal_real beta[SIZE - 1];
+  tridiagonal_real expectedEigenValues[SIZE];
+  for (int i = 0; i < SIZE; ++i) {
+    alpha[i] = 2.0;
+    if (i < SIZE - 1) {
+      beta[i] = -1.0;
+    }
+    expectedEigenValues[i] =
+        2.0 - 2.0 * cos((SIZE - i) * acos(-1.0) / (SIZE + 1));
+  }
+
+  int fail = testTridiagonalEigen(alpha, beta, expectedEigenValues, SIZE);
+
+  // Matrix with 2 on the diagonal and 1 next to it
+  tridiagonal_real smallAlpha[] = {2.0, 2.0, 2.0};
+  tridiagonal_real smallBeta[] = {1.0, 1.0};
+  tridiagonal_real smallEigenValues[] = {2.0 + sqrt(2.0), 2.0,
+                                         2.0 - sqrt(2.0)};
+  fail |= testTridiagonalEigen(smallAlpha, smallBeta, smallEigenValues, 3);
+
+  // A 1 x 1 matrix has no off diagonal element
+  tridiagonal_real singleAlpha[] = {5.0};
+  fail |= testTridiagonalEigen(singleAlpha, NULL, singleAlpha, 1);
+
+  return fail;
+}